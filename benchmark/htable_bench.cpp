@@ -0,0 +1,67 @@
+/**
+ * Exact-match index benchmark: ExtendibleHashTable against
+ * BPlusTree<unsigned long long, RID> at 10^5 and 10^6 random 64-bit keys,
+ * with the 70-frame pool the indexes run on, without and with 16 resident
+ * pages. Each run inserts every key, then looks them up in shuffled order.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <unistd.h>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rid.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/extendible_hash_table.h"
+
+static constexpr const char *kBenchFile = "htable_bench.dat";
+
+template <class Make>
+void Run(const char *name, int key_num, std::size_t resident_pages, Make make) {
+  unlink(kBenchFile);
+  std::vector<unsigned long long> keys(key_num);
+  std::mt19937_64 rng(1);
+  for (auto &key : keys) {
+    key = rng();
+  }
+  double insert_time;
+  double find_time;
+  long long checksum = 0;
+  {
+    auto bpm = make_shared<BufferPoolManager>(70, make_unique<DiskManager>(kBenchFile), LRUK_REPLACER_K,
+                                              resident_pages * BUSTUB_PAGE_SIZE);
+    auto index = make(bpm);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < key_num; ++i) {
+      index->Insert(keys[i], RID{i, i});
+    }
+    insert_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::shuffle(keys.begin(), keys.end(), rng);
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < key_num; ++i) {
+      checksum += index->Find(keys[i])->pos_;
+    }
+    find_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+  unlink(kBenchFile);
+  if (checksum != 1LL * key_num * (key_num - 1) / 2) {
+    std::printf("%s: lookups returned wrong values\n", name);
+  }
+  std::printf("%-7s keys %-8d resident %-3zu insert %5.2f us/op  find %5.2f us/op\n", name, key_num, resident_pages,
+              insert_time / key_num * 1e6, find_time / key_num * 1e6);
+}
+
+int main() {
+  using Tree = BPlusTree<unsigned long long, RID, std::less<>>;
+  using Hash = ExtendibleHashTable<unsigned long long, RID>;
+  for (int key_num : {100000, 1000000}) {
+    for (std::size_t resident_pages : {0, 16}) {
+      Run("bptree", key_num, resident_pages,
+          [](shared_ptr<BufferPoolManager> bpm) { return unique_ptr<Tree>(new Tree(bpm, std::less<>())); });
+      Run("hash", key_num, resident_pages,
+          [](shared_ptr<BufferPoolManager> bpm) { return make_unique<Hash>(bpm); });
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,78 @@
+"""Hub-to-hub query_transfer workload.
+
+Usage: python3 hub_transfer_gen.py [SEED] [COMMANDS] [STATIONS] [REPEAT] > hub.in
+
+Trains run between a few hub stations, so every pair of hubs has many
+transfer candidates. The commands mix releases, ticket sales and refunds
+with query_transfer, and each query_transfer is issued REPEAT times in a
+row. Pipe it into transfer_bench to count the transfer queries and the
+seat rows they read.
+"""
+import random
+import sys
+
+seed = int(sys.argv[1]) if len(sys.argv) > 1 else 12
+command_num = int(sys.argv[2]) if len(sys.argv) > 2 else 40000
+station_num = int(sys.argv[3]) if len(sys.argv) > 3 else 10
+repeat = int(sys.argv[4]) if len(sys.argv) > 4 else 10
+
+rng = random.Random(seed)
+stations = ["Hub%02d" % i for i in range(station_num)]
+days = [(6, d) for d in range(1, 31)] + [(7, d) for d in range(1, 32)] + [(8, d) for d in range(1, 32)]
+users = ["u%d" % i for i in range(40)]
+routes = {}
+sale = {}
+timestamp = 0
+
+
+def emit(command):
+    global timestamp
+    timestamp += 1
+    print("[%d] %s" % (timestamp, command))
+
+
+def day(index):
+    return "%02d-%02d" % days[index]
+
+
+emit("add_user -c cur -u root -p pw -n Root -m r@x -g 10")
+emit("login -u root -p pw")
+for user in users:
+    emit("add_user -c root -u %s -p pw -n N%s -m %s@m -g 1" % (user, user, user))
+    emit("login -u %s -p pw" % user)
+
+for _ in range(command_num):
+    r = rng.random()
+    if r < 0.08 or not routes:
+        train = "T%d" % rng.randint(0, 80)
+        n = rng.randint(2, station_num)
+        route = rng.sample(stations, n)
+        begin = rng.randint(0, len(days) - 1)
+        end = rng.randint(begin, min(len(days) - 1, begin + 40))
+        emit("add_train -i %s -n %d -m %d -s %s -p %s -x %02d:%02d -t %s -o %s -d %s|%s -y G" % (
+            train, n, rng.randint(1, 1000), "|".join(route),
+            "|".join(str(rng.randint(1, 500)) for _ in range(n - 1)),
+            rng.randint(0, 23), rng.randint(0, 59),
+            "|".join(str(rng.randint(1, 600)) for _ in range(n - 1)),
+            "|".join(str(rng.randint(1, 20)) for _ in range(n - 2)) if n > 2 else "_",
+            day(begin), day(end)))
+        routes.setdefault(train, route)
+        sale.setdefault(train, (begin, end))
+        emit("release_train -i %s" % train)
+    elif r < 0.80:
+        train = rng.choice(list(routes))
+        route = routes[train]
+        i, j = sorted(rng.sample(range(len(route)), 2))
+        date = day(min(len(days) - 1, rng.randint(*sale[train])))
+        emit("buy_ticket -u %s -i %s -d %s -n %d -f %s -t %s -q %s" % (
+            rng.choice(users), train, date, rng.randint(1, 60), route[i], route[j], rng.choice(["true", "false"])))
+    elif r < 0.92:
+        emit("refund_ticket -u %s -n %d" % (rng.choice(users), rng.randint(1, 4)))
+    else:
+        start, end = rng.sample(stations, 2)
+        query = "query_transfer -s %s -t %s -d %s -p %s" % (
+            start, end, day(rng.randint(0, len(days) - 1)), rng.choice(["time", "cost"]))
+        for _ in range(repeat):
+            emit(query)
+
+emit("exit")
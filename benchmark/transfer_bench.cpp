@@ -0,0 +1,67 @@
+/**
+ * query_transfer benchmark: replays a workload such as the one of
+ * hub_transfer_gen.py with the pools of the executor, discarding the output,
+ * and prints the number of transfer queries, the seat rows they read and the
+ * time spent in them. Run it from an empty directory:
+ *   python3 hub_transfer_gen.py | transfer_bench
+ */
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+#include "buffer/buffer_pool_manager.h"
+#include "executor/executor.h"
+#include "ticket/train_system.h"
+#include "user/user_system.h"
+
+int main() {
+  std::ios::sync_with_stdio(false);
+  auto user_system = make_shared<UserSystem>(shared_ptr<BufferPoolManager>(
+      new BufferPoolManager(70, make_unique<DiskManager>("user.dat"), LRUK_REPLACER_K, 66 * BUSTUB_PAGE_SIZE)));
+  auto train_system = make_shared<TrainSystem>(
+      shared_ptr<BufferPoolManager>(
+          new BufferPoolManager(220, make_unique<DiskManager>("train.dat"), LRUK_REPLACER_K, 16 * BUSTUB_PAGE_SIZE)),
+      shared_ptr<BufferPoolManager>(
+          new BufferPoolManager(70, make_unique<DiskManager>("station.dat"), LRUK_REPLACER_K, 16 * BUSTUB_PAGE_SIZE)),
+      shared_ptr<BufferPoolManager>(new BufferPoolManager(70, make_unique<DiskManager>("ticket.dat"), LRUK_REPLACER_K, 0)),
+      shared_ptr<BufferPoolManager>(new BufferPoolManager(70, make_unique<DiskManager>("waitlist.dat"), LRUK_REPLACER_K,
+                                                          16 * BUSTUB_PAGE_SIZE)),
+      shared_ptr<BufferPoolManager>(new BufferPoolManager(70, make_unique<DiskManager>("orderlist.dat"),
+                                                          LRUK_REPLACER_K, 16 * BUSTUB_PAGE_SIZE)));
+  // A null stream buffer makes std::cout drop the answers, and Parse's echo of the timestamps.
+  auto *cout_buf = std::cout.rdbuf(nullptr);
+  double transfer_time = 0;
+  int commands = 0;
+  string op;
+  string para[26];
+  while (Parse(op, para) && op != "exit") {
+    ++commands;
+    if (op == "add_user") {
+      user_system->AddUser(para);
+    } else if (op == "login") {
+      user_system->Login(para);
+    } else if (op == "add_train") {
+      train_system->AddTrain(para);
+    } else if (op == "release_train") {
+      train_system->ReleaseTrain(para);
+    } else if (op == "buy_ticket") {
+      train_system->BuyTicket(para, user_system);
+    } else if (op == "refund_ticket") {
+      train_system->RefundTicket(para, user_system);
+    } else if (op == "query_transfer") {
+      auto start = std::chrono::steady_clock::now();
+      train_system->QueryTransfer(para);
+      transfer_time += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    for (auto &i : para) {
+      i.clear();
+    }
+    op.clear();
+  }
+  std::cout.rdbuf(cout_buf);
+  std::cout.clear();
+  const auto &stats = train_system->GetTransferStats();
+  std::printf("commands %d  transfer queries %zu  seat_reads %zu  query_transfer %.0f ms\n", commands,
+              stats.queries_, stats.seat_reads_, transfer_time);
+  return 0;
+}
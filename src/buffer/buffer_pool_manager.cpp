@@ -2,8 +2,10 @@
 #include "storage/page/page_guard.h"
 #include "storage/page/b_plus_tree_header_page.h"
 
-BufferPoolManager::BufferPoolManager(size_t pool_size, unique_ptr<DiskManager> disk_manager, size_t replacer_k)
-  : pool_size_(pool_size), disk_proxy_(make_unique<BufferPoolProxy>(std::move(disk_manager))) {
+BufferPoolManager::BufferPoolManager(size_t pool_size, unique_ptr<DiskManager> disk_manager, size_t replacer_k,
+                                     size_t resident_bytes)
+  : pool_size_(pool_size), disk_proxy_(make_unique<BufferPoolProxy>(std::move(disk_manager))),
+    resident_capacity_(resident_bytes / BUSTUB_PAGE_SIZE) {
   // we allocate a consecutive memory space for the buffer pool
   pages_ = new Page[pool_size_]{};
   page_lock_ = new SpinLock[pool_size]{};
@@ -18,6 +20,7 @@ BufferPoolManager::BufferPoolManager(size_t pool_size, unique_ptr<DiskManager> d
   if (!first_flag_) {
     auto cur_guard = FetchPageRead(0);
     next_page_id_ = cur_guard.As<BPlusTreeHeaderPage>()->allocate_cnt_;
+    free_page_id_ = cur_guard.As<BPlusTreeHeaderPage>()->free_page_id_;
   }
 }
 
@@ -25,16 +28,21 @@ BufferPoolManager::~BufferPoolManager() {
   auto cur_guard = FetchPageWrite(0);
   auto cur_page = cur_guard.AsMut<BPlusTreeHeaderPage>();
   cur_page->allocate_cnt_ = next_page_id_;
+  cur_page->free_page_id_ = free_page_id_;
   cur_guard.Drop();
   FlushAllPages();
+  for (const auto &i : resident_) {
+    delete i.second;
+  }
   delete[] pages_;
   delete[] page_lock_;
 }
 
-auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
+auto BufferPoolManager::NewPage(page_id_t *page_id, bool reuse) -> Page * {
   frame_id_t id;
-  *page_id = AllocatePage();
+  bool reused;
   latch_.lock();
+  *page_id = AllocatePage(reuse, &reused);
   if (!free_list_.empty()) {
     id = free_list_.front();
     replacer_->RecordAccess(id);
@@ -53,6 +61,9 @@ auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
     }
     latch_.unlock();
   } else {
+    if (reused) {
+      DeallocatePage(*page_id);
+    }
     latch_.unlock();
     return nullptr;
   }
@@ -66,6 +77,14 @@ auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
 
 auto BufferPoolManager::FetchPage(page_id_t page_id) -> Page * {
   latch_.lock();
+  if (!resident_.empty()) {
+    auto res = resident_.find(page_id);
+    if (res != resident_.end()) {
+      ++res->second->pin_count_;
+      latch_.unlock();
+      return res->second;
+    }
+  }
   auto it = page_table_.find(page_id);
   auto id = (it == page_table_.end()) ? -1 : it->second;
   if (id != -1) {
@@ -109,6 +128,18 @@ auto BufferPoolManager::FetchPage(page_id_t page_id) -> Page * {
 
 auto BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) -> bool {
   latch_.lock();
+  if (!resident_.empty()) {
+    auto res = resident_.find(page_id);
+    if (res != resident_.end()) {
+      auto ret = res->second->pin_count_ > 0;
+      if (ret) {
+        res->second->is_dirty_ |= is_dirty;
+        --res->second->pin_count_;
+      }
+      latch_.unlock();
+      return ret;
+    }
+  }
   auto it = page_table_.find(page_id);
   if (it == page_table_.end()) {
     latch_.unlock();
@@ -133,6 +164,13 @@ auto BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) -> bool {
 
 auto BufferPoolManager::FlushPage(page_id_t page_id) -> bool {
   latch_.lock();
+  auto res = resident_.find(page_id);
+  if (res != resident_.end()) {
+    disk_proxy_->WritePage(page_id, res->second->data_);
+    res->second->is_dirty_ = false;
+    latch_.unlock();
+    return true;
+  }
   auto it = page_table_.find(page_id);
   if (it == page_table_.end()) {
     latch_.unlock();
@@ -157,25 +195,52 @@ void BufferPoolManager::FlushAllPages() {
     pages_[id].is_dirty_ = false;
     page_lock_[id].unlock();
   }
+  for (const auto &i : resident_) {
+    disk_proxy_->WritePage(i.first, i.second->data_);
+    i.second->is_dirty_ = false;
+  }
   latch_.unlock();
 }
 
 auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool {
   latch_.lock();
-  DeallocatePage(page_id);
+  if (page_id <= 0 || page_id >= next_page_id_) {
+    latch_.unlock();
+    return false;
+  }
+  auto res = resident_.find(page_id);
+  if (res != resident_.end()) {
+    if (res->second->pin_count_ > 0 || IsDeallocated(res->second->data_)) {
+      latch_.unlock();
+      return false;
+    }
+    delete res->second;
+    resident_.erase(res);
+    DeallocatePage(page_id);
+    latch_.unlock();
+    return true;
+  }
   auto it = page_table_.find(page_id);
   if (it == page_table_.end()) {
+    char data[BUSTUB_PAGE_SIZE];
+    disk_proxy_->ReadPage(page_id, data);
+    if (IsDeallocated(data)) {
+      latch_.unlock();
+      return false;
+    }
+    DeallocatePage(page_id);
     latch_.unlock();
     return true;
   }
   auto id = it->second;
-  if (pages_[id].pin_count_ > 0) {
+  if (pages_[id].pin_count_ > 0 || IsDeallocated(pages_[id].data_)) {
     latch_.unlock();
     return false;
   }
   replacer_->Remove(id);
   page_table_.erase(page_id);
   free_list_.push_back(id);
+  DeallocatePage(page_id);
   page_lock_[id].lock();
   latch_.unlock();
   pages_[id].ResetMemory();
@@ -184,7 +249,93 @@ auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool {
   return true;
 }
 
-auto BufferPoolManager::AllocatePage() -> page_id_t { return next_page_id_++; }
+auto BufferPoolManager::PinResident(page_id_t page_id) -> bool {
+  latch_.lock();
+  if (resident_.find(page_id) != resident_.end()) {
+    latch_.unlock();
+    return true;
+  }
+  if (resident_.size() >= resident_capacity_) {
+    latch_.unlock();
+    return false;
+  }
+  auto page = new Page();
+  page->page_id_ = page_id;
+  auto it = page_table_.find(page_id);
+  if (it == page_table_.end()) {
+    disk_proxy_->ReadPage(page_id, page->data_);
+  } else {
+    auto id = it->second;
+    if (pages_[id].pin_count_ > 0) {
+      latch_.unlock();
+      delete page;
+      return false;
+    }
+    // Hand the frame back to the free list, the page now lives in the resident region.
+    memcpy(page->data_, pages_[id].data_, BUSTUB_PAGE_SIZE);
+    page->is_dirty_ = pages_[id].is_dirty_;
+    replacer_->Remove(id);
+    page_table_.erase(it);
+    free_list_.push_back(id);
+    pages_[id].ResetMemory();
+    pages_[id].is_dirty_ = false;
+    pages_[id].page_id_ = INVALID_PAGE_ID;
+  }
+  resident_[page_id] = page;
+  latch_.unlock();
+  return true;
+}
+
+auto BufferPoolManager::UnpinResident(page_id_t page_id) -> bool {
+  latch_.lock();
+  auto res = resident_.find(page_id);
+  if (res == resident_.end() || res->second->pin_count_ > 0) {
+    latch_.unlock();
+    return false;
+  }
+  if (res->second->is_dirty_) {
+    disk_proxy_->WritePage(page_id, res->second->data_);
+  }
+  delete res->second;
+  resident_.erase(res);
+  latch_.unlock();
+  return true;
+}
+
+// Written after the id of the next deleted page, so that a page deleted twice can be told apart from a live one.
+static constexpr uint64_t DEALLOCATED_PAGE_MARK = 0x6465746165656c46ULL;
+
+auto BufferPoolManager::IsDeallocated(const char *data) -> bool {
+  uint64_t mark;
+  memcpy(&mark, data + sizeof(page_id_t), sizeof(mark));
+  return mark == DEALLOCATED_PAGE_MARK;
+}
+
+auto BufferPoolManager::AllocatePage(bool reuse, bool *reused) -> page_id_t {
+  *reused = reuse && free_page_id_ != 0;
+  if (!*reused) {
+    return next_page_id_++;
+  }
+  auto page_id = free_page_id_;
+  char data[BUSTUB_PAGE_SIZE];
+  disk_proxy_->ReadPage(page_id, data);
+  if (!IsDeallocated(data)) {
+    throw std::exception();
+  }
+  memcpy(&free_page_id_, data, sizeof(page_id_t));
+  // Zero the page on disk, so that neither its old content nor the mark outlives the reuse.
+  memset(data, 0, BUSTUB_PAGE_SIZE);
+  disk_proxy_->WritePage(page_id, data);
+  return page_id;
+}
+
+void BufferPoolManager::DeallocatePage(page_id_t page_id) {
+  char data[BUSTUB_PAGE_SIZE]{};
+  memcpy(data, &free_page_id_, sizeof(page_id_t));
+  memcpy(data + sizeof(page_id_t), &DEALLOCATED_PAGE_MARK, sizeof(DEALLOCATED_PAGE_MARK));
+  disk_proxy_->WritePage(page_id, data);
+  free_page_id_ = page_id;
+}
 
 auto BufferPoolManager::FetchPageBasic(page_id_t page_id) -> BasicPageGuard {
   auto ret = FetchPage(page_id);
@@ -212,8 +363,8 @@ auto BufferPoolManager::FetchPageWrite(page_id_t page_id) -> WritePageGuard {
   return {this, ret};
 }
 
-auto BufferPoolManager::NewPageGuarded(page_id_t *page_id) -> BasicPageGuard {
-  auto ret = NewPage(page_id);
+auto BufferPoolManager::NewPageGuarded(page_id_t *page_id, bool reuse) -> BasicPageGuard {
+  auto ret = NewPage(page_id, reuse);
   while (ret == nullptr) {
     assert(false);
   }
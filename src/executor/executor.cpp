@@ -31,13 +31,21 @@ shared_ptr<UserSystem> user_system;
 shared_ptr<TrainSystem> ticket_system;
 
 void Initialize() {
-  const auto user_buffer = new BufferPoolManager(70, make_unique<DiskManager>("user.dat"));
+  // The last argument is the byte budget for keeping the top levels of the index resident.
+  // The user index keeps page 0, its hash header and all 2^USER_HTABLE_HEADER_DEPTH directories resident.
+  const auto user_buffer =
+    new BufferPoolManager(70, make_unique<DiskManager>("user.dat"), LRUK_REPLACER_K, 66 * BUSTUB_PAGE_SIZE);
   user_system = make_shared<UserSystem>(shared_ptr(user_buffer));
-  const auto train_buffer = new BufferPoolManager(220, make_unique<DiskManager>("train.dat"));
-  const auto station_buffer = new BufferPoolManager(70, make_unique<DiskManager>("station.dat"));
-  const auto waitlist_buffer = new BufferPoolManager(70, make_unique<DiskManager>("waitlist.dat"));
-  const auto orderlist_buffer = new BufferPoolManager(70, make_unique<DiskManager>("orderlist.dat"));
-  const auto ticket_buffer = new BufferPoolManager(70, make_unique<DiskManager>("ticket.dat"));
+  const auto train_buffer =
+    new BufferPoolManager(220, make_unique<DiskManager>("train.dat"), LRUK_REPLACER_K, 16 * BUSTUB_PAGE_SIZE);
+  const auto station_buffer =
+    new BufferPoolManager(70, make_unique<DiskManager>("station.dat"), LRUK_REPLACER_K, 16 * BUSTUB_PAGE_SIZE);
+  const auto waitlist_buffer =
+    new BufferPoolManager(70, make_unique<DiskManager>("waitlist.dat"), LRUK_REPLACER_K, 16 * BUSTUB_PAGE_SIZE);
+  const auto orderlist_buffer =
+    new BufferPoolManager(70, make_unique<DiskManager>("orderlist.dat"), LRUK_REPLACER_K, 16 * BUSTUB_PAGE_SIZE);
+  // ticket.dat holds seat matrices and no index, so it has nothing to keep resident.
+  const auto ticket_buffer = new BufferPoolManager(70, make_unique<DiskManager>("ticket.dat"), LRUK_REPLACER_K, 0);
   ticket_system = make_shared<TrainSystem>(shared_ptr(train_buffer), shared_ptr(station_buffer),
                                            shared_ptr(ticket_buffer), shared_ptr(waitlist_buffer),
                                            shared_ptr(orderlist_buffer));
@@ -80,6 +88,8 @@ void Listen() {
       ticket_system->QueryOrder(para, user_system);
     } else if (op == "refund_ticket") {
       ticket_system->RefundTicket(para, user_system);
+    } else if (op == "dump_index") {
+      ticket_system->DumpIndex(para);
     } else {
       std::cout << "Operation not supported" << std::endl;
     }
@@ -24,8 +24,10 @@ public:
    * @param disk_manager the disk manager
    * @param replacer_k the lookback constant k for the LRU-K replacer
    * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param resident_bytes the memory budget of the resident region, see PinResident()
    */
-  BufferPoolManager(size_t pool_size, unique_ptr<DiskManager> disk_manager, size_t replacer_k = LRUK_REPLACER_K);
+  BufferPoolManager(size_t pool_size, unique_ptr<DiskManager> disk_manager, size_t replacer_k = LRUK_REPLACER_K,
+                    size_t resident_bytes = 0);
 
   /**
    * @brief Destroy an existing BufferPoolManager.
@@ -51,9 +53,11 @@ public:
    * Also, remember to record the access history of the frame in the replacer for the lru-k algorithm to work.
    *
    * @param[out] page_id id of created page
+   * @param reuse false to extend the file even if there are deleted pages, so that consecutive calls return
+   * consecutive page ids
    * @return nullptr if no new pages could be created, otherwise pointer to new page
    */
-  auto NewPage(page_id_t *page_id) -> Page *;
+  auto NewPage(page_id_t *page_id, bool reuse = true) -> Page *;
 
   /**
    * @brief PageGuard wrapper for NewPage
@@ -63,9 +67,10 @@ public:
    * BasicPageGuard structure.
    *
    * @param[out] page_id, the id of the new page
+   * @param reuse see NewPage()
    * @return BasicPageGuard holding a new page
    */
-  auto NewPageGuarded(page_id_t *page_id) -> BasicPageGuard;
+  auto NewPageGuarded(page_id_t *page_id, bool reuse = true) -> BasicPageGuard;
 
   /**
    * @brief Fetch the requested page from the buffer pool. Return nullptr if page_id needs to be fetched from the disk
@@ -136,14 +141,36 @@ public:
    * page is pinned and cannot be deleted, return false immediately.
    *
    * After deleting the page from the page table, stop tracking the frame in the replacer and add the frame
-   * back to the free list. Also, reset the page's memory and metadata. Finally, you should call DeallocatePage() to
-   * imitate freeing the page on the disk.
+   * back to the free list. Also, reset the page's memory and metadata. Finally, DeallocatePage() puts the page id on
+   * the list of deleted pages, which NewPage() takes ids from before growing the file. A page that is already on
+   * the list, or was never allocated, is rejected, so that a double delete can not put a page on the list twice.
    *
    * @param page_id id of page to be deleted
-   * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
+   * @return false if the page is pinned, already deleted or not allocated, true if deletion succeeded
    */
   auto DeletePage(page_id_t page_id) -> bool;
 
+  /**
+   * @brief Move a page into the resident region. Resident pages live outside of the buffer pool frames: they are
+   * never considered by the replacer and stay in memory until UnpinResident() or DeletePage() is called. Fetching
+   * a resident page never misses.
+   *
+   * @param page_id id of page to be made resident
+   * @return false if the page is currently pinned in a frame or the resident budget is used up, true otherwise
+   */
+  auto PinResident(page_id_t page_id) -> bool;
+
+  /**
+   * @brief Move a page out of the resident region, writing it back to disk if it is dirty.
+   *
+   * @param page_id id of resident page
+   * @return false if the page is not resident or is currently pinned, true otherwise
+   */
+  auto UnpinResident(page_id_t page_id) -> bool;
+
+  /** @brief Return the number of pages the resident region may hold. */
+  auto GetResidentCapacity() const -> size_t { return resident_capacity_; }
+
   auto IsFirstVisit() const -> bool { return first_flag_; }
 
 private:
@@ -151,6 +178,11 @@ private:
   const size_t pool_size_;
   /** The next page id to be allocated  */
   std::atomic<page_id_t> next_page_id_ = 0;
+  /**
+   * First page of the list of deleted pages, 0 if it is empty, as page 0 is never deleted. The first bytes of each
+   * deleted page on disk hold the next one. The head is kept in the header page along with next_page_id_.
+   */
+  page_id_t free_page_id_{0};
 
   /** Array of buffer pool pages. */
   Page *pages_;
@@ -162,22 +194,30 @@ private:
   unique_ptr<LRUKReplacer> replacer_;
   /** List of free frames that don't have any pages on them. */
   list<frame_id_t> free_list_;
+  /** Pages kept in the resident region, and the number of pages the region may hold. */
+  map<page_id_t, Page *> resident_;
+  size_t resident_capacity_;
   /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
   SpinLock *page_lock_;
   SpinLock latch_;
   bool first_flag_{false};
 
   /**
-   * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Allocate a page on disk, reusing a deleted page if there is one. Caller should acquire the latch before
+   * calling this function.
+   * @param reuse false to extend the file even if there are deleted pages
+   * @param[out] reused set if the page was taken from the list of deleted pages; it is zeroed on disk
    * @return the id of the allocated page
    */
-  auto AllocatePage() -> page_id_t;
+  auto AllocatePage(bool reuse, bool *reused) -> page_id_t;
 
   /**
-   * @brief Deallocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Deallocate a page on disk: write the id of the next deleted page and a mark into it. Caller should acquire
+   * the latch before calling this function.
    * @param page_id id of the page to deallocate
    */
-  void DeallocatePage(__attribute__((unused)) page_id_t page_id) {
-    // This is a no-nop right now without a more complex data structure to track deallocated pages
-  }
+  void DeallocatePage(page_id_t page_id);
+
+  /** @brief Whether data, the content of a page, carries the mark of DeallocatePage(). */
+  static auto IsDeallocated(const char *data) -> bool;
 };
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <compare>
+#include <cstring>
+
+#include "common/time.h"
+
+/**
+ * Key of the per-train, per-day indexes: the hash of a train id and a date.
+ * The hash is stored as raw bytes so that the key is 10 bytes with byte
+ * alignment, and index entries built on it carry no padding.
+ */
+struct HashDateKey {
+  HashDateKey() = default;
+  HashDateKey(unsigned long long hash, Date date) : date_(date) { memcpy(hash_, &hash, sizeof(hash)); }
+
+  [[nodiscard]] unsigned long long Hash() const {
+    unsigned long long hash;
+    memcpy(&hash, hash_, sizeof(hash));
+    return hash;
+  }
+  [[nodiscard]] Date GetDate() const { return date_; }
+  bool operator==(const HashDateKey &other) const { return Hash() == other.Hash() && date_ == other.date_; }
+
+  unsigned char hash_[sizeof(unsigned long long)]{};
+  Date date_{};
+};
+
+static_assert(sizeof(HashDateKey) == 10 && alignof(HashDateKey) == 1);
+
+inline std::strong_ordering operator<=>(const HashDateKey &lhs, const HashDateKey &rhs) {
+  auto lhs_hash = lhs.Hash();
+  auto rhs_hash = rhs.Hash();
+  return lhs_hash != rhs_hash ? lhs_hash <=> rhs_hash : lhs.date_ <=> rhs.date_;
+}
@@ -32,11 +32,13 @@ private:
   }
   void Shrink() {
     if (capacity >= 2 && (capacity >> 2) > len) {
-      while (capacity >= 2 && (capacity >> 2) > len) capacity >>= 1;
-      T *new_a = AssignMemory(capacity);
+      size_t new_capacity = capacity;
+      while (new_capacity >= 2 && (new_capacity >> 2) > len) new_capacity >>= 1;
+      T *new_a = AssignMemory(new_capacity);
       for (int i = 0; i < len; ++i) std::construct_at(new_a + i, a[i]);
       Release();
       a = new_a;
+      capacity = new_capacity;
     }
   }
 
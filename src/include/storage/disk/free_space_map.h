@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/stl/vector.hpp"
+
+// Granularity of the free space recorded for a page, in bytes.
+#define FSM_UNIT 16
+
+/**
+ * Tracks how much room is left on the record pages of a file, so that a new
+ * record goes to a page that already has space for it instead of always to
+ * the last page allocated. The map is a chain of FreeSpaceMapPage whose head
+ * is kept in the fsm_page_id_ field of the header page of the file. An upper
+ * bound of the entries of every map page is kept in memory, so that Find
+ * only reads the map pages that may have a match.
+ */
+class FreeSpaceMap {
+public:
+  FreeSpaceMap() = delete;
+  FreeSpaceMap(const FreeSpaceMap &other) = delete;
+
+  // The header page (page 0) of the file must already exist.
+  explicit FreeSpaceMap(BufferPoolManager *bpm);
+
+  // Return a page with at least size free bytes, or INVALID_PAGE_ID if there is none.
+  auto Find(uint32_t size) -> page_id_t;
+
+  // Record that page_id has free_space bytes left.
+  void Update(page_id_t page_id, uint32_t free_space);
+
+private:
+  // Return the map page covering the k-th range of page ids, appending map pages as needed.
+  auto MapPage(std::size_t k) -> page_id_t;
+
+  BufferPoolManager *bpm_;
+  vector<page_id_t> map_pages_;
+  vector<uint8_t> max_free_;
+};
@@ -3,7 +3,8 @@
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) Keys are unique, unless the value type is a PostingList, in which case a
+ *     key is associated with a sorted set of values
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
@@ -23,6 +24,36 @@
 #include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 #include "storage/page/page_guard.h"
+#include "storage/page/posting_page.h"
+
+// Every internal page has at least two children and page ids stay below 2^31, so a tree has at most 32 levels.
+#define BPLUSTREE_MAX_HEIGHT 32
+
+/**
+ * Write guards of the internal pages on the path to a leaf, kept inline in a
+ * fixed array instead of a list, so a modification allocates nothing.
+ * Guards are dropped root first, as a list would drop them.
+ */
+class WriteGuardStack {
+public:
+  WriteGuardStack() = default;
+  WriteGuardStack(const WriteGuardStack &) = delete;
+  ~WriteGuardStack() { clear(); }
+  void push_back(WritePageGuard &&guard) { guards_[size_++] = std::move(guard); }  // NOLINT
+  auto back() -> WritePageGuard & { return guards_[size_ - 1]; }
+  void pop_back() { guards_[--size_].Drop(); }  // NOLINT
+  void clear() {
+    for (int i = 0; i < size_; ++i) {
+      guards_[i].Drop();
+    }
+    size_ = 0;
+  }
+  auto size() const -> size_t { return size_; }
+
+private:
+  WritePageGuard guards_[BPLUSTREE_MAX_HEIGHT];
+  int size_{0};
+};
 
 /**
  * @brief Definition of the Context class.
@@ -40,7 +71,7 @@ public:
   page_id_t root_page_id_{INVALID_PAGE_ID};
 
   // Store the write guards of the pages that you're modifying here.
-  list<WritePageGuard> write_set_;
+  WriteGuardStack write_set_;
 
   // You may want to use this when getting value, but not necessary.
   list<ReadPageGuard> read_set_;
@@ -48,15 +79,51 @@ public:
   auto IsRootPage(page_id_t page_id) -> bool { return page_id == root_page_id_; }
 };
 
+/**
+ * Shape and space usage of a B+ tree, as reported by BPlusTree::Stats().
+ */
+struct BPlusTreeStats {
+  int height_{0};
+  // Number of pages on each level, root first.
+  vector<int> level_pages_;
+  long long entries_{0};
+  // Size over max size, averaged and minimized over all pages but an internal root, which may hold as
+  // few as two children. A root that is the only leaf is counted, so that a one-page tree reports its fill.
+  double avg_fill_{0};
+  double min_fill_{0};
+  int leaves_{0};
+  // Maximal runs of leaves that are adjacent both in key order and in the file.
+  int leaf_runs_{0};
+  // Bytes of tree pages that hold neither a page header nor an entry.
+  long long wasted_bytes_{0};
+};
+
+std::ostream &operator<<(std::ostream &os, const BPlusTreeStats &stats);
+
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
+// A leaf less than 1/BPLUSTREE_SPARSE_FACTOR full after a lazy remove is queued for compaction.
+#define BPLUSTREE_SPARSE_FACTOR 4
+// Number of queued sparse leaves that triggers a compaction pass.
+#define BPLUSTREE_COMPACT_BATCH 64
 
 // Main class providing the API for the Interactive B+ Tree.
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
   using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+  using EntryType = typename PostingTraits<ValueType>::value_type;
 
 public:
+  /**
+   * A writable reference to the value of a leaf entry. The leaf page stays
+   * pinned and write-latched as long as the slot is alive.
+   */
+  struct ValueSlot {
+    WritePageGuard guard_;
+    ValueType *value_{nullptr};
+    bool inserted_{false};
+  };
+
   explicit BPlusTree(shared_ptr<BufferPoolManager> buffer_pool_manager,
                      const KeyComparator &comparator, int leaf_max_size = LEAF_PAGE_SIZE,
                      int internal_max_size = INTERNAL_PAGE_SIZE);
@@ -69,14 +136,63 @@ public:
   // Insert a key-value pair into this B+ tree.
   auto Insert(const KeyType &key, const ValueType &value) -> bool;
 
-  // Remove a key and its value from this B+ tree.
+  // Remove a key and its value from this B+ tree. Leaves may underflow until the next compaction.
   void Remove(const KeyType &key);
 
+  // Merge or redistribute the leaves left sparse by lazy removes.
+  void Compact();
+
   // Return the value associated with a given key
   auto GetValue(const KeyType &key, vector<ValueType> *result) -> bool;
 
+  // Return the value associated with a given key, or nullopt if the key is absent
+  auto Find(const KeyType &key) -> std::optional<ValueType>;
+
   auto LowerBound(const KeyType &key) -> INDEXITERATOR_TYPE;
 
+  // Overwrite the value associated with an existing key in place.
+  auto Update(const KeyType &key, const ValueType &value) -> bool;
+
+  // Insert a key-value pair, or overwrite the value if the key exists. Returns true on insertion.
+  auto InsertOrAssign(const KeyType &key, const ValueType &value) -> bool;
+
+  // Return a writable slot for the value of key, inserting (key, value) first if the key is absent.
+  auto GetOrInsert(const KeyType &key, const ValueType &value) -> ValueSlot;
+
+  // Add a value to the posting list of a key (non-unique trees only).
+  auto InsertEntry(const KeyType &key, const EntryType &value) -> bool
+    requires PostingTraits<ValueType>::is_posting_list;
+
+  // Remove a value from the posting list of a key (non-unique trees only).
+  void RemoveEntry(const KeyType &key, const EntryType &value)
+    requires PostingTraits<ValueType>::is_posting_list;
+
+  // Return all values associated with a given key in increasing order (non-unique trees only).
+  auto GetAll(const KeyType &key, vector<EntryType> *result) -> bool
+    requires PostingTraits<ValueType>::is_posting_list;
+
+  /**
+   * Visit the entries with lo <= key <= hi in key order. The visitor is called once per leaf
+   * as visitor(const KeyType *keys, const ValueType *values, int count) with spans that point
+   * into the leaf page, which stays read-latched during the call; returning false stops the scan.
+   */
+  template <class Visitor>
+  void ScanRange(const KeyType &lo, const KeyType &hi, Visitor &&visitor);
+
+  /**
+   * Visit the values stored under key in increasing order (non-unique trees only). The visitor
+   * is called as visitor(const EntryType *values, int count) with spans that point into the
+   * leaf entry or the overflow pages; the leaf stays read-latched during the whole scan and the
+   * overflow page of a span during its call. Returning false stops the scan.
+   * @return false if the key is absent.
+   */
+  template <class Visitor>
+  auto ScanPrefix(const KeyType &key, Visitor &&visitor) -> bool
+    requires PostingTraits<ValueType>::is_posting_list;
+
+  // Walk the whole tree and report its shape and fill.
+  auto Stats() -> BPlusTreeStats;
+
   // Return the page id of the root node
   auto GetRootPageId() const -> page_id_t;
 
@@ -90,10 +206,19 @@ public:
   auto Begin(const KeyType &key) -> INDEXITERATOR_TYPE;
 
 private:
+  auto FetchLeafWrite(const KeyType &key, page_id_t root_page_id) -> WritePageGuard;
+
   void InsertInternal(const KeyType &key, Context &ctx, int ch);
 
+  void RemoveAt(LeafPage *leaf_page, const KeyType &key, int pos);
+
+  void CompactLeaf(const KeyType &key);
+
   void RemoveInternal(const KeyType &key, Context &ctx, int ch);
 
+  // Make the header page and the top internal levels resident, as far as the buffer pool budget allows.
+  void RefreshResident();
+
   // member variable
   std::string index_name_;
   shared_ptr<BufferPoolManager> bpm_;
@@ -102,4 +227,73 @@ private:
   int leaf_max_size_;
   int internal_max_size_;
   page_id_t header_page_id_;
+  vector<page_id_t> resident_pages_;
+  // Set when an internal page is created or deleted, so the resident levels are recomputed.
+  bool resident_stale_{false};
+  // One removed key per leaf that lazy deletion left sparse, pending compaction.
+  vector<KeyType> sparse_keys_;
 };
+
+/*****************************************************************************
+ * SCAN
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+template <class Visitor>
+void BPLUSTREE_TYPE::ScanRange(const KeyType &lo, const KeyType &hi, Visitor &&visitor) {
+  if (resident_stale_) {
+    RefreshResident();
+  }
+  auto cur = GetRootPageId();
+  if (cur == INVALID_PAGE_ID) {
+    return;
+  }
+  auto cur_guard = bpm_->FetchPageRead(cur);
+  auto cur_page = cur_guard.template As<InternalPage>();
+  while (!cur_page->IsLeafPage()) {
+    auto pos = cur_page->UpperBound(lo, comparator_) - 1;
+    cur_guard = bpm_->FetchPageRead(cur_page->ValueAt(pos));
+    cur_page = cur_guard.template As<InternalPage>();
+  }
+  auto leaf_page = cur_guard.template As<LeafPage>();
+  auto begin = leaf_page->GetSize() == 0 ? 0 : leaf_page->LowerBound(lo, comparator_);
+  while (true) {
+    auto end = leaf_page->GetSize() == 0 ? 0 : leaf_page->UpperBound(hi, comparator_);
+    if (begin < end && !visitor(leaf_page->KeyData() + begin, leaf_page->ValueData() + begin, end - begin)) {
+      return;
+    }
+    auto next = leaf_page->GetNextPageId();
+    if (end < leaf_page->GetSize() || next == INVALID_PAGE_ID) {
+      return;
+    }
+    cur_guard = bpm_->FetchPageRead(next);
+    leaf_page = cur_guard.template As<LeafPage>();
+    begin = 0;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+template <class Visitor>
+auto BPLUSTREE_TYPE::ScanPrefix(const KeyType &key, Visitor &&visitor) -> bool
+  requires PostingTraits<ValueType>::is_posting_list {
+  if (resident_stale_) {
+    RefreshResident();
+  }
+  auto cur = GetRootPageId();
+  if (cur == INVALID_PAGE_ID) {
+    return false;
+  }
+  auto cur_guard = bpm_->FetchPageRead(cur);
+  auto cur_page = cur_guard.template As<InternalPage>();
+  while (!cur_page->IsLeafPage()) {
+    auto pos = cur_page->UpperBound(key, comparator_) - 1;
+    cur_guard = bpm_->FetchPageRead(cur_page->ValueAt(pos));
+    cur_page = cur_guard.template As<InternalPage>();
+  }
+  auto leaf_page = cur_guard.template As<LeafPage>();
+  auto pos = leaf_page->LowerBound(key, comparator_);
+  if (pos >= leaf_page->GetSize() || leaf_page->KeyAt(pos) != key) {
+    return false;
+  }
+  leaf_page->ValueData()[pos].Scan(bpm_.get(), std::forward<Visitor>(visitor));
+  return true;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+
+#define BLOOM_FILTER_BITS_PER_KEY 10
+#define BLOOM_FILTER_NUM_HASHES 7
+
+/**
+ * An in-memory Bloom filter over 64-bit key hashes, sized for a given number
+ * of keys. MayContain never returns false for a hash that was added, so a
+ * negative answer lets an index skip its lookup. Bits can not be cleared:
+ * removed keys keep answering "maybe" until the filter is rebuilt.
+ */
+class BloomFilter {
+public:
+  BloomFilter() = default;
+  BloomFilter(const BloomFilter &other) = delete;
+  ~BloomFilter();
+
+  // Drop all bits and size the filter for capacity keys.
+  void Reset(uint32_t capacity);
+  void Add(uint64_t hash);
+  [[nodiscard]] auto MayContain(uint64_t hash) const -> bool;
+
+  [[nodiscard]] auto Enabled() const -> bool { return bits_ != nullptr; }
+  [[nodiscard]] auto Capacity() const -> uint32_t { return capacity_; }
+  [[nodiscard]] auto IsDirty() const -> bool { return is_dirty_; }
+
+  // Read the bit array from a chain of BloomFilterPage starting at first_page_id.
+  void Load(BufferPoolManager *bpm, page_id_t first_page_id, uint32_t capacity);
+
+  /**
+   * @brief Write the bit array to a chain of BloomFilterPage, reusing the pages
+   * of an existing chain and appending new ones as needed.
+   * @return the first page id of the chain
+   */
+  auto Save(BufferPoolManager *bpm, page_id_t first_page_id) -> page_id_t;
+
+private:
+  uint64_t *bits_{nullptr};
+  uint32_t capacity_{0};
+  uint32_t num_words_{0};
+  bool is_dirty_{false};
+};
@@ -0,0 +1,130 @@
+/**
+ * extendible_hash_table.h
+ *
+ * Implementation of a disk resident extendible hash table for exact-match
+ * lookups. A header page selects a directory page by the upper bits of the
+ * hash, and the directory selects a bucket page by the lower bits.
+ * (1) Keys are unique
+ * (2) support insert & remove, buckets split and merge dynamically
+ * (3) The directories grow and shrink with the local depth of their buckets
+ * (4) No range scan, use BPlusTree for ordered access
+ * (5) An optional Bloom filter answers lookups of absent keys without I/O
+ * (6) Values are stored in the buckets, so a table whose value is a whole
+ *     fixed-size record is index-organized: a lookup touches one bucket page
+ * (7) A bucket that is full when its directory is at its maximum depth grows
+ *     a chain of overflow pages, so inserting never fails
+ */
+#pragma once
+
+#include <functional>
+#include <optional>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/stl/pointers.hpp"
+#include "common/stl/vector.hpp"
+#include "storage/index/bloom_filter.h"
+#include "storage/page/b_plus_tree_header_page.h"
+#include "storage/page/extendible_htable_bucket_page.h"
+#include "storage/page/extendible_htable_directory_page.h"
+#include "storage/page/extendible_htable_header_page.h"
+#include "storage/page/page_guard.h"
+
+#define HTABLE_DEFAULT_HEADER_DEPTH 4
+#define EXTENDIBLE_HASH_TABLE_TYPE ExtendibleHashTable<KeyType, ValueType>
+
+// Main class providing the API for the extendible hash table.
+HTABLE_TEMPLATE_ARGUMENTS
+class ExtendibleHashTable {
+  using HeaderPage = ExtendibleHTableHeaderPage;
+  using DirectoryPage = ExtendibleHTableDirectoryPage;
+  using BucketPage = HTABLE_BUCKET_PAGE_TYPE;
+
+public:
+  /**
+   * A writable reference to the value of a bucket entry. The bucket page stays
+   * pinned and write-latched as long as the slot is alive.
+   */
+  struct ValueSlot {
+    WritePageGuard guard_;
+    ValueType *value_{nullptr};
+    bool inserted_{false};
+  };
+
+  /**
+   * @param bloom_capacity number of keys the Bloom filter is sized for, 0 to disable the filter.
+   * The filter is rebuilt at twice the key count as soon as the table outgrows it.
+   */
+  explicit ExtendibleHashTable(shared_ptr<BufferPoolManager> buffer_pool_manager, uint32_t bloom_capacity = 0,
+                               uint32_t header_max_depth = HTABLE_DEFAULT_HEADER_DEPTH,
+                               uint32_t directory_max_depth = HTABLE_DIRECTORY_MAX_DEPTH,
+                               uint32_t bucket_max_size = HTABLE_BUCKET_ARRAY_SIZE);
+
+  ~ExtendibleHashTable();
+
+  // Insert a key-value pair into this hash table.
+  auto Insert(const KeyType &key, const ValueType &value) -> bool;
+
+  // Remove a key and its value from this hash table.
+  void Remove(const KeyType &key);
+
+  // Return the value associated with a given key
+  auto GetValue(const KeyType &key, vector<ValueType> *result) -> bool;
+
+  // Return the value associated with a given key, or nullopt if the key is absent
+  auto Find(const KeyType &key) -> std::optional<ValueType>;
+
+  // Return a writable slot for the value of an existing key, or a slot with a null value if the key is absent.
+  auto FindForUpdate(const KeyType &key) -> ValueSlot;
+
+  // Overwrite the value associated with an existing key in place.
+  auto Update(const KeyType &key, const ValueType &value) -> bool;
+
+  // Insert a key-value pair, or overwrite the value if the key exists. Returns true on insertion.
+  auto InsertOrAssign(const KeyType &key, const ValueType &value) -> bool;
+
+  // Return a writable slot for the value of key, inserting (key, value) first if the key is absent.
+  auto GetOrInsert(const KeyType &key, const ValueType &value) -> ValueSlot;
+
+private:
+  auto Hash64(const KeyType &key) const -> uint64_t;
+
+  auto Hash(const KeyType &key) const -> uint32_t { return static_cast<uint32_t>(Hash64(key)); }
+
+  // Load the persisted Bloom filter, or rebuild it from the buckets if it is missing or stale.
+  void OpenBloomFilter(uint32_t bloom_capacity);
+
+  void RebuildBloomFilter(uint32_t capacity);
+
+  void WriteBloomMeta();
+
+  // Count a new key, and add it to the Bloom filter or rebuild a filter it overfills.
+  void OnInsert(uint64_t hash64);
+
+  // Return the directory page id responsible for hash, or INVALID_PAGE_ID if it is not created yet.
+  auto FetchDirectoryPageId(uint32_t hash) -> page_id_t;
+
+  auto NewDirectory(page_id_t *directory_page_id) -> BasicPageGuard;
+
+  // Split the full bucket at bucket_idx in two, growing the directory if needed.
+  auto SplitBucket(DirectoryPage *directory, uint32_t bucket_idx, WritePageGuard &bucket_guard) -> bool;
+
+  // Insert into the overflow chain of the full bucket at bucket_guard, which can not split.
+  auto GetOrInsertOverflow(const KeyType &key, const ValueType &value, uint64_t hash64, WritePageGuard bucket_guard)
+      -> ValueSlot;
+
+  // Remove key from the bucket at bucket_guard, which has an overflow chain. Returns false if the key is absent.
+  auto RemoveOverflow(const KeyType &key, WritePageGuard bucket_guard) -> bool;
+
+  // Merge empty buckets starting from bucket_idx with their split images, then shrink the directory.
+  void MergeBucket(DirectoryPage *directory, uint32_t bucket_idx, WritePageGuard bucket_guard);
+
+  // member variable
+  shared_ptr<BufferPoolManager> bpm_;
+  uint32_t directory_max_depth_;
+  uint32_t bucket_max_size_;
+  page_id_t header_page_id_;
+  page_id_t htable_header_page_id_;
+  BloomFilter bloom_;
+  HTableBloomMeta bloom_meta_{INVALID_PAGE_ID, 0, 0, 0};
+};
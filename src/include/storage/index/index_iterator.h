@@ -4,42 +4,48 @@
  */
 #pragma once
 
-#include "common/stl/pointers.hpp"
+#include "buffer/buffer_pool_manager.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+/**
+ * Forward iterator over the entries of the leaf chain. The default-constructed
+ * iterator is the end iterator; an iterator that runs past the last entry of the
+ * last leaf releases its page and becomes equal to it.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
 public:
-  // you may define your own constructor based on your member variables
   IndexIterator();
-  IndexIterator(shared_ptr<BufferPoolManager> bpm, ReadPageGuard guard, int index);
+  IndexIterator(BufferPoolManager *bpm, ReadPageGuard guard, int index);
   ~IndexIterator();  // NOLINT
 
   IndexIterator(IndexIterator &&other) = default;
   IndexIterator &operator=(IndexIterator &&other) = default;
 
-  auto IsEnd() -> bool;
+  [[nodiscard]] auto IsEnd() const -> bool { return bpm_ == nullptr; }
 
-  auto operator*() -> const MappingType &;
+  auto operator*() -> MappingType;
 
   auto operator++() -> IndexIterator &;
 
   auto operator==(const IndexIterator &itr) const -> bool {
+    if (IsEnd() || itr.IsEnd()) {
+      return IsEnd() == itr.IsEnd();
+    }
     return cur_guard_.PageId() == itr.cur_guard_.PageId() && index_ == itr.index_;
   }
 
-  auto operator!=(const IndexIterator &itr) const -> bool {
-    return cur_guard_.PageId() != itr.cur_guard_.PageId() || index_ != itr.index_;
-  }
+  auto operator!=(const IndexIterator &itr) const -> bool { return !(*this == itr); }
 
-  explicit operator bool() const {
-    return static_cast<bool>(bpm_);
-  }
+  explicit operator bool() const { return !IsEnd(); }
 
 private:
-  shared_ptr<BufferPoolManager> bpm_;
+  // Move to the first entry of the next non-empty leaf if index_ is past the current one.
+  void SkipExhausted();
+
+  BufferPoolManager *bpm_{nullptr};
   ReadPageGuard cur_guard_;
-  int index_;
+  int index_{0};
 };
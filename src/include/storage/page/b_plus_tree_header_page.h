@@ -12,4 +12,9 @@ public:
   page_id_t tuple_page_id_;
   page_id_t dynamic_page_id_;
   int allocate_cnt_;
+  page_id_t fsm_page_id_;
+  // First page of the BufferPoolManager's list of deleted pages, 0 if it is empty.
+  page_id_t free_page_id_;
+  // Number of registered users, kept by the UserSystem in user.dat.
+  int32_t user_num_;
 };
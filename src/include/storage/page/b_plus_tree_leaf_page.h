@@ -8,17 +8,23 @@
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
 #define LEAF_PAGE_HEADER_SIZE 16
-#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+#define LEAF_PAGE_PADDING (sizeof(KeyType) % alignof(ValueType) == 0 ? 0 : alignof(ValueType) - 1)
+#define LEAF_PAGE_SIZE \
+  ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE - LEAF_PAGE_PADDING) / (sizeof(KeyType) + sizeof(ValueType)))
 
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
  * see include/common/rid.h for detailed implementation) together within leaf
  * page. Only support unique key.
  *
+ * Keys and values are kept in two separate arrays, so that an entry takes
+ * sizeof(KeyType) + sizeof(ValueType) bytes with no padding between the key
+ * and the value, and binary search only touches the key array.
+ *
  * Leaf page format (keys are stored in order):
- *  ----------------------------------------------------------------------
- * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
- *  ----------------------------------------------------------------------
+ *  ------------------------------------------------------------------
+ * | HEADER | KEY(1) | ... | KEY(MAX) | VALUE(1) | ... | VALUE(MAX) |
+ *  ------------------------------------------------------------------
  *
  *  Header format (size in byte, 16 bytes in total):
  *  ---------------------------------------------------------------------
@@ -47,13 +53,16 @@ public:
   void SetNextPageId(page_id_t next_page_id);
   auto KeyAt(int index) const -> KeyType;
   auto ValueAt(int index) const -> ValueType;
-  auto KeyValueAt(int index) const -> const MappingType &;
+  auto ValueRefAt(int index) -> ValueType &;
+  auto KeyValueAt(int index) const -> MappingType;
+  [[nodiscard]] auto KeyData() const -> const KeyType * { return key_array_; }
+  [[nodiscard]] auto ValueData() const -> const ValueType * { return value_array_; }
   auto UpperBound(const KeyType &key, const KeyComparator &cmp) const -> int;
   auto LowerBound(const KeyType &key, const KeyComparator &cmp) const -> int;
   void SetKeyValue(int index, const KeyType &key, const ValueType &value);
 
 private:
   page_id_t next_page_id_;
-  // Flexible array member for page data.
-  MappingType array_[LEAF_PAGE_SIZE];
+  KeyType key_array_[LEAF_PAGE_SIZE];
+  ValueType value_array_[LEAF_PAGE_SIZE];
 };
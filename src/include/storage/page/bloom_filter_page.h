@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+
+#define BLOOM_FILTER_PAGE_HEADER_SIZE 8
+#define BLOOM_FILTER_PAGE_WORDS ((BUSTUB_PAGE_SIZE - BLOOM_FILTER_PAGE_HEADER_SIZE) / sizeof(uint64_t))
+
+/**
+ * A page of the on-disk image of a Bloom filter. The bit array of a filter is
+ * stored as a chain of these pages.
+ *
+ * Bloom filter page format (size in byte):
+ *  -----------------------------------------------------------
+ * | NextPageId (4) | Unused (4) | WORD(1) | ... | WORD(511) |
+ *  -----------------------------------------------------------
+ */
+class BloomFilterPage {
+public:
+  // Delete all constructor / destructor to ensure memory safety
+  BloomFilterPage() = delete;
+  BloomFilterPage(const BloomFilterPage &other) = delete;
+
+  page_id_t next_page_id_;
+  uint32_t unused_;
+  uint64_t words_[BLOOM_FILTER_PAGE_WORDS];
+};
+
+static_assert(sizeof(BloomFilterPage) <= BUSTUB_PAGE_SIZE);
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <optional>
+
+#include "common/config.h"
+#include "common/stl/pair.hpp"
+
+#define HTABLE_TEMPLATE_ARGUMENTS template <typename KeyType, typename ValueType>
+#define HTABLE_BUCKET_PAGE_TYPE ExtendibleHTableBucketPage<KeyType, ValueType>
+#define HTABLE_BUCKET_PAGE_METADATA_SIZE 16
+#define HTABLE_BUCKET_ARRAY_SIZE ((BUSTUB_PAGE_SIZE - HTABLE_BUCKET_PAGE_METADATA_SIZE) / sizeof(pair<KeyType, ValueType>))
+
+/**
+ * Bucket page of an extendible hash table. Entries are unordered, and keys are
+ * unique within the whole table. A bucket that is full at the maximum depth of
+ * its directory continues in a chain of overflow pages of the same format.
+ *
+ * Bucket page format (size in byte):
+ *  ----------------------------------------------------------------------------------------------------
+ * | CurrentSize (4) | MaxSize (4) | OverflowPageId (4) | Padding (4) | KEY(1) + VAL(1) | ... | KEY(n) + VAL(n)
+ *  ----------------------------------------------------------------------------------------------------
+ */
+HTABLE_TEMPLATE_ARGUMENTS
+class ExtendibleHTableBucketPage {
+public:
+  // Delete all constructor / destructor to ensure memory safety
+  ExtendibleHTableBucketPage() = delete;
+  ExtendibleHTableBucketPage(const ExtendibleHTableBucketPage &other) = delete;
+
+  /**
+   * After creating a new bucket page from buffer pool, must call initialize
+   * method to set default values
+   * @param max_size Max size of the bucket array
+   */
+  void Init(uint32_t max_size = HTABLE_BUCKET_ARRAY_SIZE);
+
+  // Return the position of key in the bucket, or -1 if it is absent.
+  auto Lookup(const KeyType &key) const -> int;
+  // Append an entry, the caller guarantees that the key is absent and the bucket is not full.
+  auto Append(const KeyType &key, const ValueType &value) -> int;
+  // Remove the entry at index by moving the last entry into its place.
+  void RemoveAt(uint32_t index);
+
+  auto KeyAt(uint32_t index) const -> KeyType { return array_[index].first; }
+  auto ValueAt(uint32_t index) const -> ValueType { return array_[index].second; }
+  auto ValueRefAt(uint32_t index) -> ValueType & { return array_[index].second; }
+  auto EntryAt(uint32_t index) const -> const pair<KeyType, ValueType> & { return array_[index]; }
+
+  auto Size() const -> uint32_t { return size_; }
+  void SetSize(uint32_t size) { size_ = size; }
+  auto IsFull() const -> bool { return size_ == max_size_; }
+  auto IsEmpty() const -> bool { return size_ == 0; }
+
+  // Next page of the overflow chain, or INVALID_PAGE_ID.
+  auto OverflowPageId() const -> page_id_t { return overflow_page_id_; }
+  void SetOverflowPageId(page_id_t page_id) { overflow_page_id_ = page_id; }
+
+private:
+  uint32_t size_;
+  uint32_t max_size_;
+  page_id_t overflow_page_id_;
+  uint32_t padding_;
+  pair<KeyType, ValueType> array_[HTABLE_BUCKET_ARRAY_SIZE];
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+
+#define HTABLE_DIRECTORY_PAGE_METADATA_SIZE 8
+#define HTABLE_DIRECTORY_MAX_DEPTH 9
+#define HTABLE_DIRECTORY_ARRAY_SIZE (1 << HTABLE_DIRECTORY_MAX_DEPTH)
+
+/**
+ * Directory page of an extendible hash table. The lower global_depth bits of a
+ * hash select a slot, and each slot points to a bucket page. A bucket with
+ * local depth d is shared by all slots agreeing on the lower d bits.
+ *
+ * Directory page format (size in byte):
+ *  --------------------------------------------------------------------------------------
+ * | MaxDepth (4) | GlobalDepth (4) | LocalDepths (512) | BucketPageIds (2048) | Free (1528)
+ *  --------------------------------------------------------------------------------------
+ */
+class ExtendibleHTableDirectoryPage {
+public:
+  // Delete all constructor / destructor to ensure memory safety
+  ExtendibleHTableDirectoryPage() = delete;
+  ExtendibleHTableDirectoryPage(const ExtendibleHTableDirectoryPage &other) = delete;
+
+  /**
+   * After creating a new directory page from buffer pool, must call initialize
+   * method to set default values
+   * @param max_depth Max depth of the directory page
+   */
+  void Init(uint32_t max_depth = HTABLE_DIRECTORY_MAX_DEPTH);
+
+  auto HashToBucketIndex(uint32_t hash) const -> uint32_t;
+  auto GetBucketPageId(uint32_t bucket_idx) const -> page_id_t;
+  void SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id);
+
+  // Index of the slot that differs from bucket_idx in the highest bit covered by its local depth.
+  auto GetSplitImageIndex(uint32_t bucket_idx) const -> uint32_t;
+
+  auto GetGlobalDepth() const -> uint32_t;
+  auto GetMaxDepth() const -> uint32_t;
+  auto GetGlobalDepthMask() const -> uint32_t;
+  auto GetLocalDepthMask(uint32_t bucket_idx) const -> uint32_t;
+  // Double the directory, the new upper half mirrors the lower half.
+  void IncrGlobalDepth();
+  void DecrGlobalDepth();
+  // The directory can shrink if every local depth is smaller than the global depth.
+  auto CanShrink() const -> bool;
+  auto Size() const -> uint32_t;
+
+  auto GetLocalDepth(uint32_t bucket_idx) const -> uint32_t;
+  void SetLocalDepth(uint32_t bucket_idx, uint8_t local_depth);
+
+private:
+  uint32_t max_depth_;
+  uint32_t global_depth_;
+  uint8_t local_depths_[HTABLE_DIRECTORY_ARRAY_SIZE];
+  page_id_t bucket_page_ids_[HTABLE_DIRECTORY_ARRAY_SIZE];
+};
+
+static_assert(sizeof(ExtendibleHTableDirectoryPage) == HTABLE_DIRECTORY_PAGE_METADATA_SIZE +
+                                                       HTABLE_DIRECTORY_ARRAY_SIZE +
+                                                       sizeof(page_id_t) * HTABLE_DIRECTORY_ARRAY_SIZE);
+static_assert(sizeof(ExtendibleHTableDirectoryPage) <= BUSTUB_PAGE_SIZE);
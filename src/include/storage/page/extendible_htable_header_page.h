@@ -0,0 +1,59 @@
+#pragma once
+
+#include "common/config.h"
+
+#define HTABLE_HEADER_PAGE_METADATA_SIZE 20
+#define HTABLE_HEADER_MAX_DEPTH 9
+#define HTABLE_HEADER_ARRAY_SIZE (1 << HTABLE_HEADER_MAX_DEPTH)
+
+/**
+ * State of the Bloom filter of a hash table: the first page of its on-disk
+ * image, the number of keys it was sized for, the number of keys in the table
+ * and the number of removals since the filter was built.
+ */
+struct HTableBloomMeta {
+  page_id_t page_id_;
+  uint32_t capacity_;
+  uint32_t num_keys_;
+  uint32_t num_removed_;
+};
+
+/**
+ * Header page of an extendible hash table. The upper max_depth bits of a hash
+ * select one of the directory pages.
+ *
+ * Header page format (size in byte):
+ *  ------------------------------------------------------------
+ * | MaxDepth (4) | BloomMeta (16) | DirectoryPageIds (2048) | Free (2028)
+ *  ------------------------------------------------------------
+ */
+class ExtendibleHTableHeaderPage {
+public:
+  // Delete all constructor / destructor to ensure memory safety
+  ExtendibleHTableHeaderPage() = delete;
+  ExtendibleHTableHeaderPage(const ExtendibleHTableHeaderPage &other) = delete;
+
+  /**
+   * After creating a new header page from buffer pool, must call initialize
+   * method to set default values
+   * @param max_depth Max depth of the header page
+   */
+  void Init(uint32_t max_depth = HTABLE_HEADER_MAX_DEPTH);
+
+  auto HashToDirectoryIndex(uint32_t hash) const -> uint32_t;
+  auto GetDirectoryPageId(uint32_t directory_idx) const -> page_id_t;
+  void SetDirectoryPageId(uint32_t directory_idx, page_id_t directory_page_id);
+  auto MaxSize() const -> uint32_t;
+  auto GetBloomMeta() const -> const HTableBloomMeta & { return bloom_meta_; }
+  void SetBloomMeta(const HTableBloomMeta &bloom_meta) { bloom_meta_ = bloom_meta; }
+
+private:
+  uint32_t max_depth_;
+  HTableBloomMeta bloom_meta_;
+  page_id_t directory_page_ids_[HTABLE_HEADER_ARRAY_SIZE];
+};
+
+static_assert(sizeof(page_id_t) == 4);
+static_assert(sizeof(ExtendibleHTableHeaderPage) ==
+              sizeof(page_id_t) * HTABLE_HEADER_ARRAY_SIZE + HTABLE_HEADER_PAGE_METADATA_SIZE);
+static_assert(sizeof(ExtendibleHTableHeaderPage) <= BUSTUB_PAGE_SIZE);
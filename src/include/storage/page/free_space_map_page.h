@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+
+#define FSM_PAGE_HEADER_SIZE 4
+#define FSM_PAGE_SLOTS (BUSTUB_PAGE_SIZE - FSM_PAGE_HEADER_SIZE)
+
+/**
+ * A page of a free space map. The k-th page of the chain holds one byte for
+ * every page id in [k * FSM_PAGE_SLOTS, (k + 1) * FSM_PAGE_SLOTS), the free
+ * space of that page in units of FSM_UNIT bytes, rounded down. Pages that do
+ * not hold records are left at 0.
+ *
+ * Free space map page format (size in byte):
+ *  -----------------------------------------------------------
+ * | NextPageId (4) | FREE(0) | FREE(1) | ... | FREE(4091) |
+ *  -----------------------------------------------------------
+ */
+class FreeSpaceMapPage {
+public:
+  // Delete all constructor / destructor to ensure memory safety
+  FreeSpaceMapPage() = delete;
+  FreeSpaceMapPage(const FreeSpaceMapPage &other) = delete;
+
+  page_id_t next_page_id_;
+  uint8_t free_[FSM_PAGE_SLOTS];
+};
+
+static_assert(sizeof(FreeSpaceMapPage) <= BUSTUB_PAGE_SIZE);
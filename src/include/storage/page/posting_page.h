@@ -0,0 +1,125 @@
+#pragma once
+
+#include <type_traits>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/stl/vector.hpp"
+
+#define POSTING_INLINE_SIZE 3
+#define POSTING_PAGE_HEADER_SIZE 8
+#define POSTING_PAGE_SIZE ((BUSTUB_PAGE_SIZE - POSTING_PAGE_HEADER_SIZE) / sizeof(T))
+
+/**
+ * Overflow page of a posting list. A long posting list is stored as a chain of
+ * posting pages, each of them holding a sorted run of values, and the runs are
+ * in increasing order along the chain.
+ *
+ * Posting page format:
+ *  ----------------------------------------------------------
+ * | CurrentSize (4) | NextPageId (4) | VAL(1) | ... | VAL(n) |
+ *  ----------------------------------------------------------
+ */
+template <class T>
+class PostingPage {
+  static_assert(POSTING_PAGE_SIZE > 1);
+public:
+  PostingPage() = delete;
+  PostingPage(const PostingPage &other) = delete;
+
+  void Init();
+  [[nodiscard]] int32_t Size() const { return size_; }
+  [[nodiscard]] bool Full() const { return size_ == POSTING_PAGE_SIZE; }
+  [[nodiscard]] page_id_t GetNextPageId() const { return next_page_id_; }
+  void SetNextPageId(page_id_t id) { next_page_id_ = id; }
+  [[nodiscard]] const T &At(int index) const { return data_[index]; }
+  [[nodiscard]] const T *Data() const { return data_; }
+  [[nodiscard]] int LowerBound(const T &val) const;
+  void InsertAt(int index, const T &val);
+  void RemoveAt(int index);
+  /**
+   * Move the upper half of this page to an empty page that follows it in the chain.
+   */
+  void MoveHalfTo(PostingPage *other);
+  [[nodiscard]] static int32_t MaxSize() { return POSTING_PAGE_SIZE; }
+
+private:
+  int32_t size_;
+  page_id_t next_page_id_;
+  T data_[POSTING_PAGE_SIZE];
+};
+
+/**
+ * The value stored under a key of a non-unique B+ tree: a sorted set of values.
+ * Short lists are kept inline in the leaf entry; once a list outgrows the inline
+ * area, all of its values are moved to a chain of posting pages.
+ */
+template <class T>
+struct PostingList {
+  using value_type = T;
+
+  PostingList() = default;
+  explicit PostingList(const T &val) : size_(1) { inline_[0] = val; }
+
+  [[nodiscard]] int32_t Size() const { return size_; }
+  [[nodiscard]] bool IsInline() const { return overflow_page_id_ == INVALID_PAGE_ID; }
+
+  /**
+   * @brief Insert a value into the list.
+   * @return false if the value is already in the list.
+   */
+  bool Insert(BufferPoolManager *bpm, const T &val);
+
+  /**
+   * @brief Remove a value from the list.
+   * @return false if the value is not in the list.
+   */
+  bool Remove(BufferPoolManager *bpm, const T &val);
+
+  /**
+   * @brief Append all values of the list to result, in increasing order.
+   */
+  void GetAll(BufferPoolManager *bpm, vector<T> *result) const;
+
+  /**
+   * @brief Call visitor(const T *values, int count) on each sorted run of the list in place,
+   * until it returns false.
+   */
+  template <class Visitor>
+  void Scan(BufferPoolManager *bpm, Visitor &&visitor) const {
+    if (IsInline()) {
+      if (size_ > 0) {
+        visitor(static_cast<const T *>(inline_), size_);
+      }
+      return;
+    }
+    auto cur = overflow_page_id_;
+    while (cur != INVALID_PAGE_ID) {
+      auto cur_guard = bpm->FetchPageRead(cur);
+      auto cur_page = cur_guard.template As<PostingPage<T>>();
+      if (!visitor(cur_page->Data(), cur_page->Size())) {
+        return;
+      }
+      cur = cur_page->GetNextPageId();
+    }
+  }
+
+  int32_t size_{0};
+  page_id_t overflow_page_id_{INVALID_PAGE_ID};
+  T inline_[POSTING_INLINE_SIZE]{};
+};
+
+/**
+ * Tells whether a tree value type is a posting list, and the type of the values it holds.
+ */
+template <class T>
+struct PostingTraits {
+  static constexpr bool is_posting_list = false;
+  using value_type = T;
+};
+
+template <class T>
+struct PostingTraits<PostingList<T>> {
+  static constexpr bool is_posting_list = true;
+  using value_type = T;
+};
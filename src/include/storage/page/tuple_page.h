@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstring>
 #include <string>
+#include <string_view>
 
 #include "common/config.h"
 
@@ -8,7 +10,10 @@
 #define TUPLE_MAX_SIZE ((BUSTUB_PAGE_SIZE - TUPLE_HEADER_SIZE) / sizeof(T))
 #define LINKED_TUPLE_HEADER_SIZE 8
 #define LINKED_TUPLE_MAX_SIZE ((BUSTUB_PAGE_SIZE - LINKED_TUPLE_HEADER_SIZE) / sizeof(T))
-#define DYNAMIC_TUPLE_HEADER_SIZE 4
+#define DYNAMIC_TUPLE_HEADER_SIZE 8
+#define DYNAMIC_TUPLE_SLOT_SIZE 4
+#define DYNAMIC_TUPLE_DATA_SIZE (BUSTUB_PAGE_SIZE - DYNAMIC_TUPLE_HEADER_SIZE)
+#define DYNAMIC_TUPLE_MAX_RECORD_SIZE (DYNAMIC_TUPLE_DATA_SIZE - DYNAMIC_TUPLE_SLOT_SIZE)
 
 template <class T>
 class TuplePage {
@@ -51,40 +56,88 @@ private:
 
 using std::string;
 
+/**
+ * Slotted page holding variable-length records. The slot directory grows from
+ * the front of the page and the records grow from the back. A record is
+ * addressed by its slot id, which stays valid when the record is moved by a
+ * compaction or a growing Update, so a RID into this page is stable until the
+ * record is deleted. Freed slots are reused by later inserts.
+ *
+ *  --------------------------------------------------------------------
+ * | HEADER | SLOT(0) | SLOT(1) | ... | free | ... | REC(1) | REC(0) |
+ *  --------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 8 bytes in total):
+ *  ------------------------------------------------------------------
+ * | SlotCount (2) | RecordBegin (2) | Garbage (2) | Unused (2) |
+ *  ------------------------------------------------------------------
+ *  Slot format: Offset (2) | Size (2), an offset of 0 marks a free slot.
+ */
 class DynamicTuplePage {
  public:
-  DynamicTuplePage() = default;
+  DynamicTuplePage() = delete;
+  DynamicTuplePage(const DynamicTuplePage &other) = delete;
 
-  int32_t Append(const string &data);
+  void Init();
 
-  [[nodiscard]] string At(std::size_t pos) const;
+  // Largest record that Insert can still store, counting the space compaction would recover.
+  [[nodiscard]] uint32_t FreeSpace() const;
 
-  [[nodiscard]] bool IsFull(const string &data) const;
+  int32_t Insert(const string &data) { return InsertBytes(data.data(), data.size()); }
 
+  // Returns the slot id of the new record, or -1 if the page has no room for it.
   template <class T>
-  bool IsFull(const T *data, std::size_t n) const {
-    return size_ + sizeof(T) * n > BUSTUB_PAGE_SIZE - DYNAMIC_TUPLE_HEADER_SIZE;
+  int32_t Insert(const T *data, std::size_t n) {
+    return InsertBytes(reinterpret_cast<const char *>(data), sizeof(T) * n);
   }
 
+  [[nodiscard]] string At(int32_t slot) const { return string(View(slot)); }
+
+  // The bytes of a record in place, valid while the page guard is held.
+  [[nodiscard]] std::string_view View(int32_t slot) const { return {data_ + slots_[slot].offset_, slots_[slot].size_}; }
+
   template <class T>
-  int32_t Append(const T *data, std::size_t n) {
-    auto ret = size_;
-    memcpy(data_ + size_, data, sizeof(T) * n);
-    size_ += sizeof(T) * n;
-    return ret;
+  void As(int32_t slot, T *data, std::size_t n) const {
+    memcpy(data, data_ + slots_[slot].offset_, sizeof(T) * n);
   }
 
   template <class T>
-  void As(std::size_t pos, T *data, std::size_t n) const {
-    memcpy(data, data_ + pos, sizeof(T) * n);
+  void Modify(int32_t slot, const T *data, std::size_t n) {
+    memcpy(data_ + slots_[slot].offset_, data, sizeof(T) * n);
   }
 
+  // Replace a record by one of any size, keeping its slot id. Returns false if the page has no room for it.
   template <class T>
-  void Modify(std::size_t pos, T *data, std::size_t n) {
-    memcpy(data_ + pos, data, sizeof(T) * n);
+  bool Update(int32_t slot, const T *data, std::size_t n) {
+    return UpdateBytes(slot, reinterpret_cast<const char *>(data), sizeof(T) * n);
   }
 
+  void Delete(int32_t slot);
+
+  // Move all records to the back of the page, so that the free space is contiguous.
+  void Compact();
+
  private:
-  char data_[BUSTUB_PAGE_SIZE - DYNAMIC_TUPLE_HEADER_SIZE]{};
-  int32_t size_{0};
+  struct Slot {
+    uint16_t offset_;
+    uint16_t size_;
+  };
+
+  int32_t InsertBytes(const char *data, std::size_t size);
+
+  bool UpdateBytes(int32_t slot, const char *data, std::size_t size);
+
+  // Carve size bytes for slot out of the free space, compacting the page first if needed.
+  void Allocate(int32_t slot, uint16_t size);
+
+  [[nodiscard]] uint32_t ContiguousSpace() const { return record_begin_ - DYNAMIC_TUPLE_SLOT_SIZE * slot_count_; }
+
+  uint16_t slot_count_;
+  uint16_t record_begin_;
+  uint16_t garbage_;
+  uint16_t unused_;
+  union {
+    char data_[DYNAMIC_TUPLE_DATA_SIZE];
+    Slot slots_[DYNAMIC_TUPLE_DATA_SIZE / DYNAMIC_TUPLE_SLOT_SIZE];
+  };
 };
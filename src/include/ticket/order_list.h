@@ -3,7 +3,8 @@
 #include <string>
 
 #include "common/time.h"
-#include "storage/index/b_plus_tree.h"
+#include "storage/index/extendible_hash_table.h"
+#include "ticket/station_dictionary.h"
 
 using std::string;
 
@@ -13,8 +14,8 @@ struct OrderInfo {
   int32_t price_{};
   int32_t num_{};
   int32_t timestamp_{};
-  char from_[41]{};
-  char to_[41]{};
+  int32_t from_{};
+  int32_t to_{};
   char train_id_[21]{};
   OrderStatus status_{OrderStatus::ksuccess};
   Time leave_{};
@@ -26,13 +27,13 @@ public:
   OrderList() = delete;
   explicit OrderList(shared_ptr<BufferPoolManager> bpm);
   ~OrderList();
-  void QueryOrder(const string &username) const;
+  void QueryOrder(const string &username, const StationDictionary &stations) const;
   bool RefundTicket(const string &username, std::size_t num, OrderInfo &info);
   void QueueSucceed(const string &username, std::size_t timestamp);
   void AppendOrder(const string &username, const OrderInfo &order_info);
 
 private:
   shared_ptr<BufferPoolManager> bpm_;
-  unique_ptr<BPlusTree<unsigned long long, page_id_t, std::less<>>> index_;
+  unique_ptr<ExtendibleHashTable<unsigned long long, page_id_t>> index_;
   page_id_t next_tuple_id_{};
 };
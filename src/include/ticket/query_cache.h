@@ -0,0 +1,88 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <ostream>
+
+#include "common/rid.h"
+#include "common/stl/map.hpp"
+#include "common/stl/vector.hpp"
+#include "common/time.h"
+
+// Number of query_ticket results the TrainSystem keeps in memory.
+#define QUERY_CACHE_CAPACITY 256
+
+// The parameters of a query_ticket request, with the stations as StationDictionary ids.
+struct QueryKey {
+  int32_t from_;
+  int32_t to_;
+  Date date_;
+  bool order_by_cost_;
+
+  std::strong_ordering operator<=>(const QueryKey &other) const = default;
+};
+
+// The seat counts of a train on a date, the train being named by its seat matrix.
+struct SeatKey {
+  RID matrix_;
+  Date date_;
+
+  std::strong_ordering operator<=>(const SeatKey &other) const = default;
+};
+
+struct QueryCacheEntry {
+  QueryKey key_;
+  string output_;
+  // Seat counts the result was computed from.
+  vector<SeatKey> seats_;
+  QueryCacheEntry *prev_;
+  QueryCacheEntry *next_;
+};
+
+/**
+ * Output of the most recent query_ticket requests, at most capacity of them,
+ * evicted least recently used first. A result stays valid until a train is
+ * released through both of its stations or the seats of one of the trains in
+ * it are bought or refunded on the date it was read. The first case is rare
+ * and checked against every entry; for the second the cache indexes the
+ * entries by the seat counts they read.
+ */
+class QueryCache {
+public:
+  explicit QueryCache(std::size_t capacity) : capacity_(capacity) {}
+  QueryCache(const QueryCache &other) = delete;
+  ~QueryCache();
+
+  // Return the output of key and mark it the most recently used, or nullptr on a miss.
+  const string *Find(const QueryKey &key);
+
+  // Add the output of key, which read the seat counts seats, as the most recently used.
+  void Insert(const QueryKey &key, const string &output, const vector<SeatKey> &seats);
+
+  // Drop the results between two of the count stations of a train being released.
+  void InvalidateStations(const int32_t *stations, int count);
+
+  // Drop the results that read the seat counts seat.
+  void InvalidateSeats(const SeatKey &seat);
+
+  [[nodiscard]] std::size_t Hits() const { return hits_; }
+  [[nodiscard]] std::size_t Misses() const { return misses_; }
+  [[nodiscard]] std::size_t Size() const { return entries_.size(); }
+
+private:
+  void Unlink(QueryCacheEntry *entry);
+  void PushFront(QueryCacheEntry *entry);
+  // Remove entry from the cache and from the seat index, and free it.
+  void Drop(QueryCacheEntry *entry);
+
+  map<QueryKey, QueryCacheEntry *, std::less<>> entries_;
+  map<SeatKey, vector<QueryCacheEntry *>, std::less<>> readers_;
+  // Most recently used first.
+  QueryCacheEntry *head_{nullptr};
+  QueryCacheEntry *tail_{nullptr};
+  std::size_t capacity_;
+  std::size_t hits_{0};
+  std::size_t misses_{0};
+};
+
+std::ostream &operator<<(std::ostream &os, const QueryCache &cache);
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "common/rid.h"
+#include "common/stl/map.hpp"
+
+struct SeatCacheEntry {
+  // Row of the seat matrix the counts belong to, which identifies the (train, date).
+  RID row_;
+  int32_t max_seat_;
+  int8_t station_num_;
+  // Set when the counts are newer than the row in ticket.dat.
+  bool dirty_;
+  // Seats left on each of the station_num_ - 1 segments.
+  int32_t *seats_;
+  SeatCacheEntry *prev_;
+  SeatCacheEntry *next_;
+};
+
+/**
+ * In-memory cache of the seat counts of (train, date) pairs, in unpacked
+ * form, with LRU eviction under a byte budget. The cache only keeps the
+ * entries: the TicketSystem reads a row on a miss and writes back the dirty
+ * entries it evicts or flushes, so that buy_ticket and refund_ticket on a
+ * popular train touch ticket.dat only when its entry leaves the cache.
+ */
+class SeatCache {
+public:
+  explicit SeatCache(std::size_t budget_bytes);
+  SeatCache(const SeatCache &other) = delete;
+  ~SeatCache();
+
+  // Return the entry of row and mark it the most recently used, or nullptr on a miss.
+  SeatCacheEntry *Find(const RID &row);
+
+  // Add a clean entry for row, with its seats to be filled by the caller, as the most recently used.
+  SeatCacheEntry *Insert(const RID &row, int8_t station_num, int32_t max_seat);
+
+  /**
+   * @brief Unlink the least recently used entry if the cache is over its budget.
+   * The caller writes it back if it is dirty and hands it to Release.
+   * @return the entry, or nullptr if the cache fits in its budget
+   */
+  SeatCacheEntry *EvictOverBudget();
+
+  void Release(SeatCacheEntry *entry);
+
+  // Visit every entry as visitor(SeatCacheEntry *).
+  template <class Visitor>
+  void ForEach(Visitor &&visitor) {
+    for (auto cur = head_; cur != nullptr; cur = cur->next_) {
+      visitor(cur);
+    }
+  }
+
+  [[nodiscard]] std::size_t Hits() const { return hits_; }
+  [[nodiscard]] std::size_t Misses() const { return misses_; }
+  [[nodiscard]] std::size_t Bytes() const { return bytes_; }
+
+private:
+  static std::size_t EntrySize(int8_t station_num) {
+    return sizeof(SeatCacheEntry) + sizeof(int32_t) * (station_num - 1);
+  }
+
+  void Unlink(SeatCacheEntry *entry);
+  void PushFront(SeatCacheEntry *entry);
+
+  map<RID, SeatCacheEntry *, std::less<>> entries_;
+  // Most recently used first.
+  SeatCacheEntry *head_{nullptr};
+  SeatCacheEntry *tail_{nullptr};
+  std::size_t budget_bytes_;
+  std::size_t bytes_{0};
+  std::size_t hits_{0};
+  std::size_t misses_{0};
+};
+
+std::ostream &operator<<(std::ostream &os, const SeatCache &cache);
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * Range operations over the int32_t seat counts of a train, seats[i] being
+ * the seats left between station i and station i + 1. Ranges are
+ * [begin, end) in segment positions. They are plain loops on purpose: GCC
+ * vectorizes them under the tree's flags, and benchmark/seat_kernel_bench.cpp
+ * shows them beating hand-written SSE2 at every train length.
+ */
+
+// Seats left on every segment of [begin, end). Callers pass non-empty ranges: an empty one yields INT32_MAX,
+// which is not a seat count.
+inline int32_t SeatRangeMin(const int32_t *seats, int begin, int end) {
+  int32_t ret = INT32_MAX;
+  for (int i = begin; i < end; ++i) {
+    ret = std::min(ret, seats[i]);
+  }
+  return ret;
+}
+
+// Add delta to every segment of [begin, end).
+inline void SeatRangeAdd(int32_t *seats, int begin, int end, int32_t delta) {
+  for (int i = begin; i < end; ++i) {
+    seats[i] += delta;
+  }
+}
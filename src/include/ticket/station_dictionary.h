@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/stl/map.hpp"
+#include "common/stl/pointers.hpp"
+#include "common/stl/vector.hpp"
+
+using std::string;
+
+struct StationName {
+  char name_[41]{};
+};
+
+/**
+ * Interns station names to dense integer ids, so that trains, orders and the
+ * station index store and compare ids instead of strings. The names are kept
+ * in a chain of LinkedTuplePage<StationName> in the file of the station index,
+ * whose head is the tuple_page_id_ field of its header page, and the id of a
+ * name is its position in the chain. The dictionary is read into memory on
+ * construction and new names are appended to the chain as they are interned.
+ */
+class StationDictionary {
+public:
+  StationDictionary() = delete;
+  explicit StationDictionary(shared_ptr<BufferPoolManager> bpm);
+
+  // Return the id of name, adding it to the dictionary if it is new.
+  int32_t Intern(std::string_view name);
+
+  // Return the id of name, or -1 if no train has been added through it.
+  [[nodiscard]] int32_t Find(std::string_view name) const;
+
+  [[nodiscard]] const string &Name(int32_t id) const { return names_[id]; }
+
+private:
+  shared_ptr<BufferPoolManager> bpm_;
+  map<unsigned long long, int32_t> ids_;
+  vector<string> names_;
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+};
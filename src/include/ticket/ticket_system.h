@@ -1,22 +1,56 @@
 #pragma once
 
 #include "common/rid.h"
-#include "common/time.h"
-#include "storage/index/b_plus_tree.h"
+#include "ticket/seat_cache.h"
+#include "ticket/train_stop.h"
 #include "ticket/train_system.h"
 
+// Bytes of seat counts the TicketSystem keeps in memory.
+#define SEAT_CACHE_BYTES (256 * 1024)
+
 struct DetailedTrainInfo;
 
+/**
+ * Seat counts of the released trains. Each train owns a seat matrix in
+ * ticket.dat, reserved by ReleaseTrain: one row per day of its sale window,
+ * holding the number of seats sold on each segment between two stations.
+ * The counts are packed with the fewest bits that hold the train's seat
+ * count, 17 bits at most, and a row is padded to whole bytes. Rows never
+ * straddle a page, and a matrix spans consecutive pages, so the row of a
+ * date is found by arithmetic on the matrix's RID (its first page and the
+ * byte offset in that page), the day offset from start_sale_, the station
+ * count and the seat count. A fresh page reads as zero seats sold, so only
+ * the pages need to be allocated. Small matrices share the last page of the
+ * file; its id and used bytes are kept in the header page. The rows in use
+ * are kept unpacked in a SeatCache and written back when they are evicted
+ * and on shutdown. Locating a row needs no index lookup, and the cache keeps
+ * rows across commands, so there is no per-command memo of seat lookups.
+ */
 class TicketSystem {
 public:
   TicketSystem() = delete;
   explicit TicketSystem(shared_ptr<BufferPoolManager> bpm);
   ~TicketSystem();
-  void FetchTicket(Date date, int32_t seat_num, DetailedTrainInfo &info) const;
+
+  // Reserve the seat matrix of a train with days days of sale, station_num stations and max_seat seats.
+  RID ReserveSeats(int days, int station_num, int32_t max_seat);
+
+  // Read the seats left on date into info.seat_num_. A train not released yet has all seats left.
+  void FetchTicket(Date date, DetailedTrainInfo &info);
+  void FetchSeats(const TrainStop &stop, Date date, int32_t *seats);
   void ModifyTicket(Date date, const DetailedTrainInfo &info);
 
+  [[nodiscard]] const SeatCache &Cache() const { return cache_; }
+
 private:
+  // Return the cache entry of row, reading the row on a miss.
+  SeatCacheEntry *FetchRow(const RID &row, int station_num, int32_t max_seat);
+  // Write back the evicted entries until the cache fits in its budget.
+  void Evict();
+  void WriteBack(const SeatCacheEntry *entry);
+
   shared_ptr<BufferPoolManager> bpm_;
-  unique_ptr<BPlusTree<pair<unsigned long long, Date>, RID, std::less<>>> index_;
-  page_id_t dynamic_page_id_{};
+  page_id_t tail_page_id_{INVALID_PAGE_ID};
+  int32_t tail_used_{0};
+  SeatCache cache_{SEAT_CACHE_BYTES};
 };
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <compare>
+
+#include "common/rid.h"
+#include "common/time.h"
+
+/**
+ * An entry of the station index: a released train passing the station, with
+ * everything query_ticket needs to know about the stop. A query is answered
+ * from the posting lists of its two stations and the seat counts of the
+ * chosen date, without loading the trains. Entries are ordered by the RID of
+ * the train record, so the lists of two stations can be merged.
+ */
+struct TrainStop {
+  RID rid_{};
+  // Price from the first station, and minutes from the departure at the first station
+  // until the arrival at and the departure from this station.
+  int32_t price_sum_{};
+  int32_t arrive_{};
+  int32_t leave_{};
+  int32_t seat_num_{};
+  char train_id_[21]{};
+  Date start_sale_{}, end_sale_{};
+  Moment start_time_{};
+  int8_t pos_{};
+  int8_t station_num_{};
+  RID seats_{};
+
+  bool operator==(const TrainStop &other) const { return rid_ == other.rid_; }
+};
+
+inline std::strong_ordering operator<=>(const TrainStop &lhs, const TrainStop &rhs) {
+  return lhs.rid_ <=> rhs.rid_;
+}
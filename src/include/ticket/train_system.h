@@ -4,40 +4,67 @@
 #include "common/rid.h"
 #include "common/time.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/disk/free_space_map.h"
+#include "storage/index/extendible_hash_table.h"
 #include "storage/page/tuple_page.h"
 #include "ticket/order_list.h"
+#include "ticket/query_cache.h"
+#include "ticket/station_dictionary.h"
 #include "ticket/ticket_system.h"
+#include "ticket/train_stop.h"
 #include "ticket/waitlist.h"
 #include "user/user_system.h"
 
+// Initial number of train ids the Bloom filter of the train index is sized for.
+#define TRAIN_BLOOM_CAPACITY (1 << 14)
+#define STATION_MAX_NUM 100
+
 class TicketSystem;
 
+/**
+ * A train is stored as a single record of a DynamicTuplePage: this header,
+ * then the price_sum_, arrive_, leave_ and stations_ arrays of
+ * DetailedTrainInfo, station_num_ entries each. Loading a train is one page
+ * access.
+ */
 struct TrainInfo {
   char train_id_[21]{};
   int32_t seat_num_{};
-  RID stations_{}; // Type: string
-  RID prices_{}; // Type: int32_t
-  RID travel_time_{}; // Type: int16_t
-  RID stopover_time_{}; // Type: int16_t
   Date start_sale_{}, end_sale_{};
   Moment start_time_{};
   int8_t station_num_{};
   char type_{};
   bool released_{false};
+  // The seat matrix in the TicketSystem, reserved on release.
+  RID seats_{INVALID_PAGE_ID, 0};
 };
 
 struct DetailedTrainInfo {
   string train_id_{};
-  vector<string> stations_{};
   int32_t max_seat_{};
   int32_t seat_num_[100]{};
-  int32_t prices_[100]{};
-  int16_t travel_time_[100]{};
-  int16_t stopover_time_[100]{};
+  // Price from the first station, and minutes from the departure at the first station
+  // until the arrival at and the departure from each station.
+  int32_t price_sum_[100]{};
+  int32_t arrive_[100]{};
+  int32_t leave_[100]{};
+  // Ids of the stations in the StationDictionary.
+  int32_t stations_[100]{};
   Date start_sale_{}, end_sale_{};
   Moment start_time_{};
   int8_t station_num_{};
   char type_;
+  bool released_{};
+  RID seats_{INVALID_PAGE_ID, 0};
+};
+
+/**
+ * Work done by query_transfer since start-up, read by benchmark/transfer_bench.cpp.
+ */
+struct TransferStats {
+  std::size_t queries_{0};
+  // Seat rows read, one per train and date.
+  std::size_t seat_reads_{0};
 };
 
 class TrainSystem {
@@ -70,53 +97,32 @@ class TrainSystem {
 
   void RefundTicket(const string para[26], const shared_ptr<UserSystem> &user_system);
 
- private:
-  bool FetchTrainInfo(const string &train_id, TrainInfo &info) const;
+  void DumpIndex(const string para[26]);
 
-  void FetchTrainInfoStation(const string &station_name, vector<RID> &ret);
+  auto GetTransferStats() const -> const TransferStats & { return transfer_stats_; }
 
-  void FetchDynamicInfo(const RID &rid, string &ret) const;
+ private:
+  void FetchTrainInfoStation(int32_t station_id, vector<TrainStop> &ret);
 
   RID WriteDynamicInfo(const string &data);
 
-  void FetchDetailedTrainInfo(const RID &rid, DetailedTrainInfo &info) const;
+  void DeleteDynamicInfo(const RID &rid);
+
+  WritePageGuard FetchDynamicPage(std::size_t size);
 
-  void FetchDetailedTrainInfo(const TrainInfo &brief, Date date, DetailedTrainInfo &info) const;
-
-  void FetchDetailedTrainInfo(const TrainInfo &brief, DetailedTrainInfo &info) const;
-
-  template <class T>
-  void FetchDynamicInfo(const RID &rid, T *ret, std::size_t n) const {
-    auto cur_guard = bpm_->FetchPageRead(rid.page_id_);
-    auto cur_page = cur_guard.As<DynamicTuplePage>();
-    cur_page->As<T>(rid.pos_, ret, n);
-  };
-
-  template <class T>
-  RID WriteDynamicInfo(const T *data, std::size_t n) {
-    DynamicTuplePage *cur_page;
-    if (dynamic_page_id_ == INVALID_PAGE_ID) {
-      auto cur_guard = bpm_->NewPageGuarded(&dynamic_page_id_);
-      cur_page = cur_guard.AsMut<DynamicTuplePage>();
-    } else {
-      auto cur_guard = bpm_->FetchPageWrite(dynamic_page_id_);
-      cur_page = cur_guard.AsMut<DynamicTuplePage>();
-      if (cur_page->IsFull(data, n)) {
-        auto new_guard = bpm_->NewPageGuarded(&dynamic_page_id_);
-        cur_page = new_guard.AsMut<DynamicTuplePage>();
-      }
-    }
-    auto pos = cur_page->Append(data, n);
-    return {dynamic_page_id_, pos};
-  }
+  bool FetchDetailedTrainInfo(const string &train_id, DetailedTrainInfo &info) const;
+
+  void FetchDetailedTrainInfo(const RID &rid, DetailedTrainInfo &info) const;
 
   shared_ptr<BufferPoolManager> bpm_;
   shared_ptr<BufferPoolManager> station_bpm_;
-  unique_ptr<BPlusTree<unsigned long long, RID, std::less<>>> index_;
-  unique_ptr<BPlusTree<pair<unsigned long long, RID>, RID, std::less<>>> station_index_;
+  unique_ptr<ExtendibleHashTable<unsigned long long, RID>> index_;
+  unique_ptr<FreeSpaceMap> free_space_map_;
+  unique_ptr<BPlusTree<unsigned long long, PostingList<TrainStop>, std::less<>>> station_index_;
+  unique_ptr<StationDictionary> station_dictionary_;
   unique_ptr<TicketSystem> ticket_system_;
   unique_ptr<WaitList> waitlist_;
   unique_ptr<OrderList> orderlist_;
-  page_id_t tuple_page_id_;
-  page_id_t dynamic_page_id_;
+  unique_ptr<QueryCache> query_cache_;
+  TransferStats transfer_stats_;
 };
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "common/stl/vector.hpp"
+#include "ticket/train_system.h"
+
+/**
+ * In-memory hash join for query_transfer. Build indexes the second legs, the
+ * trains through the destination, by the stations where they can be boarded,
+ * i.e. every station before the destination. The query then probes the table
+ * with each station after the departure on a first-leg train, so a transfer
+ * is found in one lookup instead of matching the station lists of every pair
+ * of trains. Station ids are dense, so the bucket of a station is its id
+ * modulo the table size. The price and duration of each second leg are kept
+ * in the table, with their minimums over all legs as lower bounds for the
+ * search.
+ */
+class TransferPlanner {
+public:
+  struct Leg {
+    // Index of the train in the vector given to Build.
+    int32_t train_;
+    // Positions of the transfer station and of the destination in the train.
+    int32_t transfer_pos_;
+    int32_t end_pos_;
+    // Price and minutes from the transfer station to the destination.
+    int32_t price_;
+    int32_t duration_;
+  };
+
+  /**
+   * @brief Index the second legs of trains, which all pass through end_id.
+   * The table keeps indexes into trains, which must outlive the planner.
+   */
+  void Build(const vector<DetailedTrainInfo> &trains, int32_t end_id);
+
+  [[nodiscard]] int32_t MinPrice() const { return min_price_; }
+  [[nodiscard]] int32_t MinDuration() const { return min_duration_; }
+
+  // Visit the second legs that can be boarded at station, as visitor(const Leg &).
+  template <class Visitor>
+  void Probe(int32_t station, Visitor &&visitor) const {
+    if (buckets_.empty()) {
+      return;
+    }
+    for (auto i = buckets_[station & mask_]; i != -1; i = entries_[i].next_) {
+      if (entries_[i].station_ == station) {
+        visitor(entries_[i].leg_);
+      }
+    }
+  }
+
+private:
+  struct Entry {
+    int32_t station_;
+    Leg leg_;
+    // Next entry of the same bucket, or -1.
+    int32_t next_;
+  };
+
+  vector<Entry> entries_;
+  vector<int32_t> buckets_;
+  int32_t mask_{0};
+  int32_t min_price_{0};
+  int32_t min_duration_{0};
+};
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "common/time.h"
+#include "common/hash_date_key.h"
 #include "storage/index/b_plus_tree.h"
 
 struct WaitInfo {
@@ -47,10 +47,13 @@ public:
 
   int32_t GetTimeStamp() { return ++timestamp_; };
 
+  BPlusTreeStats IndexStats() { return index_->Stats(); }
+
 private:
-  void RemoveEmptyPage(const string &train_id, Date date, WritePageGuard &cur_guard);
+  // Returns false (and resets cur_guard) if no page with queued requests is left.
+  bool RemoveEmptyPage(const string &train_id, Date date, WritePageGuard &cur_guard);
   shared_ptr<BufferPoolManager> bpm_;
-  unique_ptr<BPlusTree<pair<unsigned long long, Date>, page_id_t, std::less<>>> index_;
+  unique_ptr<BPlusTree<HashDateKey, page_id_t, std::less<>>> index_;
   page_id_t next_tuple_id_;
   int32_t timestamp_;
 };
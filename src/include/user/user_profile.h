@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+struct UserProfile {
+  char username_[21]{};
+  char password_[31]{};
+  char name_[21]{};
+  char mail_addr_[31]{};
+  int8_t login_info_;
+  int8_t privilege_{-1};
+};
+
+std::ostream &operator<<(std::ostream &os, const UserProfile &val);
@@ -0,0 +1,76 @@
+#include <algorithm>
+
+#include "storage/disk/free_space_map.h"
+#include "storage/page/b_plus_tree_header_page.h"
+#include "storage/page/free_space_map_page.h"
+
+FreeSpaceMap::FreeSpaceMap(BufferPoolManager *bpm) : bpm_(bpm) {
+  page_id_t cur;
+  {
+    auto header_guard = bpm_->FetchPageRead(0);
+    cur = header_guard.As<BPlusTreeHeaderPage>()->fsm_page_id_;
+  }
+  while (cur != INVALID_PAGE_ID) {
+    auto cur_guard = bpm_->FetchPageRead(cur);
+    auto cur_page = cur_guard.As<FreeSpaceMapPage>();
+    map_pages_.push_back(cur);
+    max_free_.push_back(*std::max_element(cur_page->free_, cur_page->free_ + FSM_PAGE_SLOTS));
+    cur = cur_page->next_page_id_;
+  }
+}
+
+/*
+ * A request of size bytes needs ceil(size / FSM_UNIT) units, while the entries
+ * are rounded down, so a page found here always has the room. The in-memory
+ * bound of a map page is only raised by Update; it is tightened here when a
+ * scan of the page finds nothing.
+ */
+auto FreeSpaceMap::Find(uint32_t size) -> page_id_t {
+  auto need = (size + FSM_UNIT - 1) / FSM_UNIT;
+  if (need > UINT8_MAX) {
+    return INVALID_PAGE_ID;
+  }
+  for (std::size_t k = 0; k < map_pages_.size(); ++k) {
+    if (max_free_[k] < need) {
+      continue;
+    }
+    auto cur_guard = bpm_->FetchPageRead(map_pages_[k]);
+    auto cur_page = cur_guard.As<FreeSpaceMapPage>();
+    auto it = std::find_if(cur_page->free_, cur_page->free_ + FSM_PAGE_SLOTS,
+                           [need](uint8_t free) { return free >= need; });
+    if (it != cur_page->free_ + FSM_PAGE_SLOTS) {
+      return static_cast<page_id_t>(k * FSM_PAGE_SLOTS + (it - cur_page->free_));
+    }
+    max_free_[k] = *std::max_element(cur_page->free_, cur_page->free_ + FSM_PAGE_SLOTS);
+  }
+  return INVALID_PAGE_ID;
+}
+
+void FreeSpaceMap::Update(page_id_t page_id, uint32_t free_space) {
+  auto k = static_cast<std::size_t>(page_id) / FSM_PAGE_SLOTS;
+  auto units = static_cast<uint8_t>(std::min<uint32_t>(free_space / FSM_UNIT, UINT8_MAX));
+  auto cur_guard = bpm_->FetchPageWrite(MapPage(k));
+  auto cur_page = cur_guard.AsMut<FreeSpaceMapPage>();
+  cur_page->free_[page_id % FSM_PAGE_SLOTS] = units;
+  max_free_[k] = std::max(max_free_[k], units);
+}
+
+auto FreeSpaceMap::MapPage(std::size_t k) -> page_id_t {
+  while (map_pages_.size() <= k) {
+    page_id_t new_page_id;
+    {
+      auto new_guard = bpm_->NewPageGuarded(&new_page_id);
+      new_guard.AsMut<FreeSpaceMapPage>()->next_page_id_ = INVALID_PAGE_ID;
+    }
+    if (map_pages_.empty()) {
+      auto header_guard = bpm_->FetchPageWrite(0);
+      header_guard.AsMut<BPlusTreeHeaderPage>()->fsm_page_id_ = new_page_id;
+    } else {
+      auto last_guard = bpm_->FetchPageWrite(map_pages_[map_pages_.size() - 1]);
+      last_guard.AsMut<FreeSpaceMapPage>()->next_page_id_ = new_page_id;
+    }
+    map_pages_.push_back(new_page_id);
+    max_free_.push_back(0);
+  }
+  return map_pages_[k];
+}
@@ -3,8 +3,9 @@
 #include <functional>
 
 #include "common/rid.h"
-#include "common/time.h"
+#include "common/hash_date_key.h"
 #include "storage/index/b_plus_tree.h"
+#include "ticket/train_stop.h"
 
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(shared_ptr<BufferPoolManager> buffer_pool_manager,
@@ -20,11 +21,17 @@ BPLUSTREE_TYPE::BPlusTree(shared_ptr<BufferPoolManager> buffer_pool_manager,
     root_page->root_page_id_ = INVALID_PAGE_ID;
     root_page->tuple_page_id_ = INVALID_PAGE_ID;
     root_page->dynamic_page_id_ = INVALID_PAGE_ID;
+    root_page->fsm_page_id_ = INVALID_PAGE_ID;
   }
+  RefreshResident();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-BPLUSTREE_TYPE::~BPlusTree() = default;
+BPLUSTREE_TYPE::~BPlusTree() {
+  if (!sparse_keys_.empty()) {
+    Compact();
+  }
+}
 /*
  * Helper function to decide whether current b+tree is empty
  */
@@ -40,72 +47,46 @@ auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return GetRootPageId() == 0; }
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, vector<ValueType> *result) -> bool {
-  // Declaration of context instance.
-  Context ctx;
-  ctx.root_page_id_ = GetRootPageId();
-  if (ctx.root_page_id_ == INVALID_PAGE_ID) {
+  auto value = Find(key);
+  if (!value.has_value()) {
     return false;
   }
-  auto cur = ctx.root_page_id_;
-  auto cur_guard = bpm_->FetchPageRead(cur);
-  auto cur_page = cur_guard.As<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
-  ctx.read_set_.push_back(std::move(cur_guard));
-  while (!cur_page->IsLeafPage()) {
-    auto pos = cur_page->UpperBound(key, comparator_) - 1;
-    cur = cur_page->ValueAt(pos);
-    cur_guard = bpm_->FetchPageRead(cur);
-    cur_page = cur_guard.As<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
-    ctx.read_set_.push_back(std::move(cur_guard));
-    ctx.read_set_.pop_front();
-  }
-  cur_guard = std::move(ctx.read_set_.back());
-  ctx.read_set_.pop_back();
-  auto leaf_page = cur_guard.As<B_PLUS_TREE_LEAF_PAGE_TYPE>();
-  auto pos = leaf_page->LowerBound(key, comparator_);
-  if (pos >= leaf_page->GetSize()) {
-    return false;
-  }
-  if (leaf_page->KeyAt(pos) != key) {
-    return false;
-  }
-  result->push_back(leaf_page->ValueAt(pos));
+  result->push_back(*value);
   return true;
 }
 
+/*
+ * Point lookup without heap allocation: a read only descent never needs more
+ * than the guard of the current page, so the guard is simply handed down level
+ * by level instead of being kept in a Context.
+ */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::LowerBound(const KeyType &key) -> INDEXITERATOR_TYPE {
-  // Declaration of context instance.
-  Context ctx;
-  ctx.root_page_id_ = GetRootPageId();
-  if (ctx.root_page_id_ == INVALID_PAGE_ID) {
-    return {};
+auto BPLUSTREE_TYPE::Find(const KeyType &key) -> std::optional<ValueType> {
+  if (resident_stale_) {
+    RefreshResident();
+  }
+  auto cur = GetRootPageId();
+  if (cur == INVALID_PAGE_ID) {
+    return std::nullopt;
   }
-  auto cur = ctx.root_page_id_;
   auto cur_guard = bpm_->FetchPageRead(cur);
-  auto cur_page = cur_guard.As<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
-  ctx.read_set_.push_back(std::move(cur_guard));
+  auto cur_page = cur_guard.template As<InternalPage>();
   while (!cur_page->IsLeafPage()) {
     auto pos = cur_page->UpperBound(key, comparator_) - 1;
-    cur = cur_page->ValueAt(pos);
-    cur_guard = bpm_->FetchPageRead(cur);
-    cur_page = cur_guard.As<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
-    ctx.read_set_.push_back(std::move(cur_guard));
-    ctx.read_set_.pop_front();
+    cur_guard = bpm_->FetchPageRead(cur_page->ValueAt(pos));
+    cur_page = cur_guard.template As<InternalPage>();
   }
-  cur_guard = std::move(ctx.read_set_.back());
-  ctx.read_set_.pop_back();
-  auto leaf_page = cur_guard.As<B_PLUS_TREE_LEAF_PAGE_TYPE>();
+  auto leaf_page = cur_guard.template As<LeafPage>();
   auto pos = leaf_page->LowerBound(key, comparator_);
-  if (pos >= leaf_page->GetSize()) {
-    INDEXITERATOR_TYPE ret(bpm_, std::move(cur_guard), leaf_page->GetSize() - 1);
-    if (ret.IsEnd()) {
-      return {};
-    }
-    ++ret;
-    return std::move(ret);
+  if (pos >= leaf_page->GetSize() || leaf_page->KeyAt(pos) != key) {
+    return std::nullopt;
   }
-  INDEXITERATOR_TYPE ret(bpm_, std::move(cur_guard), pos);
-  return std::move(ret);
+  return leaf_page->ValueAt(pos);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::LowerBound(const KeyType &key) -> INDEXITERATOR_TYPE {
+  return Begin(key);
 }
 
 /*****************************************************************************
@@ -120,6 +101,9 @@ auto BPLUSTREE_TYPE::LowerBound(const KeyType &key) -> INDEXITERATOR_TYPE {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value) -> bool {
+  if (resident_stale_) {
+    RefreshResident();
+  }
   // Declaration of context instance.
   Context ctx;
   ctx.header_page_ = bpm_->FetchPageWrite(header_page_id_);
@@ -195,6 +179,7 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value) -> bool
   new_page->SetNextPageId(leaf_page->GetNextPageId());
   leaf_page->SetNextPageId(new_id);
   if (ctx.root_page_id_ == cur) {
+    resident_stale_ = true;
     int root_id;
     auto root_guard = bpm_->NewPageGuarded(&root_id);
     auto root_page = root_guard.AsMut<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
@@ -225,6 +210,7 @@ void BPLUSTREE_TYPE::InsertInternal(const KeyType &key, Context &ctx, int ch) {
     cur_page->IncreaseSize(1);
     return;
   }
+  resident_stale_ = true;
   pair<KeyType, page_id_t> tmp[internal_max_size_ + 1];
   for (int i = 0; i < pos; ++i) {
     tmp[i] = make_pair(cur_page->KeyAt(i), cur_page->ValueAt(i));
@@ -271,12 +257,72 @@ void BPLUSTREE_TYPE::InsertInternal(const KeyType &key, Context &ctx, int ch) {
 /*
  * Delete key & value pair associated with input key
  * If current tree is empty, return immediately.
- * If not, User needs to first find the right leaf page as deletion target, then
- * delete entry from leaf page. Remember to deal with redistribute or merge if
- * necessary.
+ * Deletion is lazy: the entry is removed from its leaf in place and the leaf
+ * is allowed to underflow, so only the leaf is write-latched. A leaf that
+ * falls below 1/BPLUSTREE_SPARSE_FACTOR full is remembered by the removed key,
+ * and once BPLUSTREE_COMPACT_BATCH of them are pending, Compact() merges or
+ * redistributes them with their siblings.
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key) {
+  if (resident_stale_) {
+    RefreshResident();
+  }
+  auto root_page_id = GetRootPageId();
+  if (root_page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  auto leaf_guard = FetchLeafWrite(key, root_page_id);
+  auto leaf_page = leaf_guard.template AsMut<LeafPage>();
+  auto pos = leaf_page->LowerBound(key, comparator_);
+  if (pos >= leaf_page->GetSize() || leaf_page->KeyAt(pos) != key) {
+    return;
+  }
+  RemoveAt(leaf_page, key, pos);
+  if (sparse_keys_.size() >= BPLUSTREE_COMPACT_BATCH) {
+    leaf_guard.Drop();
+    Compact();
+  }
+}
+
+/*
+ * Remove the entry at pos from a write-latched leaf, and remember the leaf
+ * for compaction if it became sparse.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemoveAt(LeafPage *leaf_page, const KeyType &key, int pos) {
+  auto cur_size = leaf_page->GetSize();
+  for (int i = pos + 1; i < cur_size; ++i) {
+    leaf_page->SetKeyValue(i - 1, leaf_page->KeyAt(i), leaf_page->ValueAt(i));
+  }
+  leaf_page->IncreaseSize(-1);
+  if ((cur_size - 1) * BPLUSTREE_SPARSE_FACTOR < leaf_max_size_) {
+    sparse_keys_.push_back(key);
+  }
+}
+
+/*
+ * Rebalance every leaf that lazy deletion left sparse since the last pass.
+ * Also run when the tree is closed.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Compact() {
+  auto keys = sparse_keys_;
+  sparse_keys_.clear();
+  for (const auto &key : keys) {
+    CompactLeaf(key);
+  }
+}
+
+/*
+ * Find the leaf that key belongs to and, if it is below the minimum size,
+ * merge it with a sibling when both fit into one page, or otherwise move
+ * entries over from the sibling until the two are even. The separator in the
+ * parent is fixed accordingly, and a merge removes the emptied page from the
+ * parent, which may cascade up through RemoveInternal.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::CompactLeaf(const KeyType &key) {
   Context ctx;
   ctx.header_page_ = bpm_->FetchPageWrite(header_page_id_);
   ctx.root_page_id_ = ctx.header_page_->As<BPlusTreeHeaderPage>()->root_page_id_;
@@ -285,14 +331,13 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key) {
   }
   auto cur = ctx.root_page_id_;
   auto cur_guard = bpm_->FetchPageWrite(cur);
-  auto cur_page = cur_guard.As<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
-  int lp;
-  int rp;
-  int ls;
-  int rs;
+  auto cur_page = cur_guard.As<InternalPage>();
+  int lp = -1;
+  int rp = -1;
+  page_id_t ls = INVALID_PAGE_ID;
+  page_id_t rs = INVALID_PAGE_ID;
   while (!cur_page->IsLeafPage()) {
     if (cur_page->GetSize() > std::max(internal_max_size_ >> 1, 2)) {
-      // ctx.header_page_ = std::nullopt;
       ctx.write_set_.clear();
     }
     ctx.write_set_.push_back(std::move(cur_guard));
@@ -307,23 +352,10 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key) {
       rs = cur_page->ValueAt(rp);
     }
     cur_guard = bpm_->FetchPageWrite(cur);
-    cur_page = cur_guard.As<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
-  }
-  auto leaf_page = cur_guard.AsMut<B_PLUS_TREE_LEAF_PAGE_TYPE>();
-  if (leaf_page->GetSize() > leaf_max_size_ >> 1) {
-    // ctx.header_page_ = std::nullopt;
-    ctx.write_set_.clear();
-  }
-  auto pos = leaf_page->LowerBound(key, comparator_);
-  if (pos >= cur_page->GetSize() || leaf_page->KeyAt(pos) != key) {
-    return;
+    cur_page = cur_guard.As<InternalPage>();
   }
+  auto leaf_page = cur_guard.AsMut<LeafPage>();
   auto cur_size = leaf_page->GetSize();
-  for (int i = pos + 1; i < cur_size; ++i) {
-    leaf_page->SetKeyValue(i - 1, leaf_page->KeyAt(i), leaf_page->ValueAt(i));
-  }
-  --cur_size;
-  leaf_page->IncreaseSize(-1);
   if (cur_size >= leaf_max_size_ >> 1) {
     return;
   }
@@ -335,67 +367,51 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key) {
     }
     return;
   }
-  WritePageGuard l_guard;
-  WritePageGuard r_guard;
-  B_PLUS_TREE_LEAF_PAGE_TYPE *l_page;
-  B_PLUS_TREE_LEAF_PAGE_TYPE *r_page;
+  auto parent_page = ctx.write_set_.back().AsMut<InternalPage>();
   if (lp != -1) {
-    l_guard = bpm_->FetchPageWrite(ls);
-    l_page = l_guard.AsMut<B_PLUS_TREE_LEAF_PAGE_TYPE>();
-    if (l_page->GetSize() > l_page->GetMinSize()) {
+    auto l_guard = bpm_->FetchPageWrite(ls);
+    auto l_page = l_guard.AsMut<LeafPage>();
+    auto l_size = l_page->GetSize();
+    if (l_size + cur_size > leaf_max_size_) {
+      auto n = (l_size - cur_size) >> 1;
       for (int i = cur_size - 1; i >= 0; --i) {
-        leaf_page->SetKeyValue(i + 1, leaf_page->KeyAt(i), leaf_page->ValueAt(i));
+        leaf_page->SetKeyValue(i + n, leaf_page->KeyAt(i), leaf_page->ValueAt(i));
       }
-      leaf_page->IncreaseSize(1);
-      auto l_size = l_page->GetSize();
-      leaf_page->SetKeyValue(0, l_page->KeyAt(l_size - 1), l_page->ValueAt(l_size - 1));
-      l_page->IncreaseSize(-1);
-      auto parent_guard = std::move(ctx.write_set_.back());
-      auto parent_page = parent_guard.AsMut<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
+      for (int i = 0; i < n; ++i) {
+        leaf_page->SetKeyValue(i, l_page->KeyAt(l_size - n + i), l_page->ValueAt(l_size - n + i));
+      }
+      leaf_page->IncreaseSize(n);
+      l_page->IncreaseSize(-n);
       parent_page->SetKeyAt(lp + 1, leaf_page->KeyAt(0));
       return;
     }
+    for (int i = 0; i < cur_size; ++i) {
+      l_page->SetKeyValue(l_size + i, leaf_page->KeyAt(i), leaf_page->ValueAt(i));
+    }
+    l_page->IncreaseSize(cur_size);
+    l_page->SetNextPageId(leaf_page->GetNextPageId());
+    cur_guard.Drop();
     l_guard.Drop();
+    bpm_->DeletePage(cur);
+    RemoveInternal(parent_page->KeyAt(lp + 1), ctx, cur);
+    return;
   }
-  if (rp != -1) {
-    r_guard = bpm_->FetchPageWrite(rs);
-    r_page = r_guard.AsMut<B_PLUS_TREE_LEAF_PAGE_TYPE>();
-    if (r_page->GetSize() > r_page->GetMinSize()) {
-      leaf_page->SetKeyValue(cur_size, r_page->KeyAt(0), r_page->ValueAt(0));
-      leaf_page->IncreaseSize(1);
-      for (int i = 1; i < r_page->GetSize(); ++i) {
-        r_page->SetKeyValue(i - 1, r_page->KeyAt(i), r_page->ValueAt(i));
-      }
-      r_page->IncreaseSize(-1);
-      auto parent_guard = std::move(ctx.write_set_.back());
-      auto parent_page = parent_guard.AsMut<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
-      parent_page->SetKeyAt(rp, r_page->KeyAt(0));
-      return;
+  auto r_guard = bpm_->FetchPageWrite(rs);
+  auto r_page = r_guard.AsMut<LeafPage>();
+  auto r_size = r_page->GetSize();
+  if (cur_size + r_size > leaf_max_size_) {
+    auto n = (r_size - cur_size) >> 1;
+    for (int i = 0; i < n; ++i) {
+      leaf_page->SetKeyValue(cur_size + i, r_page->KeyAt(i), r_page->ValueAt(i));
     }
-    r_guard.Drop();
-  }
-  if (lp != -1) {
-    l_guard = bpm_->FetchPageWrite(ls);
-    l_page = l_guard.AsMut<B_PLUS_TREE_LEAF_PAGE_TYPE>();
-    auto parent_page = ctx.write_set_.back().As<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
-    if (lp != -1) {
-      auto l_size = l_page->GetSize();
-      for (int i = 0; i < cur_size; ++i) {
-        l_page->SetKeyValue(l_size + i, leaf_page->KeyAt(i), leaf_page->ValueAt(i));
-      }
-      l_page->IncreaseSize(cur_size);
-      l_page->SetNextPageId(leaf_page->GetNextPageId());
-      cur_guard.Drop();
-      l_guard.Drop();
-      bpm_->DeletePage(cur);
-      RemoveInternal(parent_page->KeyAt(lp + 1), ctx, cur);
-      return;
+    for (int i = n; i < r_size; ++i) {
+      r_page->SetKeyValue(i - n, r_page->KeyAt(i), r_page->ValueAt(i));
     }
+    leaf_page->IncreaseSize(n);
+    r_page->IncreaseSize(-n);
+    parent_page->SetKeyAt(rp, r_page->KeyAt(0));
+    return;
   }
-  r_guard = bpm_->FetchPageWrite(rs);
-  r_page = r_guard.AsMut<B_PLUS_TREE_LEAF_PAGE_TYPE>();
-  auto parent_page = ctx.write_set_.back().As<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
-  auto r_size = r_page->GetSize();
   for (int i = 0; i < r_size; ++i) {
     leaf_page->SetKeyValue(cur_size + i, r_page->KeyAt(i), r_page->ValueAt(i));
   }
@@ -415,6 +431,7 @@ void BPLUSTREE_TYPE::RemoveInternal(const KeyType &key, Context &ctx, int ch) {
   auto cur_page = cur_guard.AsMut<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
   auto cur_size = cur_page->GetSize();
   if (ctx.IsRootPage(cur) && cur_size == 2) {
+    resident_stale_ = true;
     if (cur_page->ValueAt(0) == ch) {
       ctx.header_page_->AsMut<BPlusTreeHeaderPage>()->root_page_id_ = cur_page->ValueAt(1);
       cur_guard.Drop();
@@ -490,6 +507,7 @@ void BPLUSTREE_TYPE::RemoveInternal(const KeyType &key, Context &ctx, int ch) {
     }
     r_guard.Drop();
   }
+  resident_stale_ = true;
   if (lp != -1) {
     l_guard = bpm_->FetchPageWrite(ls);
     l_page = l_guard.AsMut<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
@@ -519,6 +537,239 @@ void BPLUSTREE_TYPE::RemoveInternal(const KeyType &key, Context &ctx, int ch) {
   RemoveInternal(parent_page->KeyAt(rp), ctx, rs);
 }
 
+/*****************************************************************************
+ * RESIDENT LEVELS
+ *****************************************************************************/
+/*
+ * Recompute the set of resident pages: the header page first, then the
+ * internal levels from the root down, level by level, until the budget of the
+ * buffer pool is used up. Leaves are never made resident. Called lazily after
+ * an internal page has been split or merged away. Only the pages that left the
+ * set are unpinned and only the ones that joined it are pinned, so a split
+ * deep in the tree does not move the upper levels in and out of the pool.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RefreshResident() {
+  resident_stale_ = false;
+  auto capacity = bpm_->GetResidentCapacity();
+  vector<page_id_t> target;
+  if (capacity > 0) {
+    target.push_back(header_page_id_);
+  }
+  auto root_page_id = GetRootPageId();
+  vector<page_id_t> level;
+  if (root_page_id != INVALID_PAGE_ID) {
+    level.push_back(root_page_id);
+  }
+  while (!level.empty() && target.size() < capacity) {
+    vector<page_id_t> next_level;
+    for (auto page_id : level) {
+      if (target.size() >= capacity) {
+        break;
+      }
+      auto cur_guard = bpm_->FetchPageRead(page_id);
+      auto cur_page = cur_guard.template As<InternalPage>();
+      if (cur_page->IsLeafPage()) {
+        break;
+      }
+      for (int i = 0; i < cur_page->GetSize(); ++i) {
+        next_level.push_back(cur_page->ValueAt(i));
+      }
+      target.push_back(page_id);
+    }
+    level = next_level;
+  }
+  map<page_id_t, bool> in_target;
+  for (auto page_id : target) {
+    in_target[page_id] = true;
+  }
+  for (auto page_id : resident_pages_) {
+    if (in_target.find(page_id) == in_target.end()) {
+      bpm_->UnpinResident(page_id);
+    }
+  }
+  // PinResident returns at once for a page that is already resident.
+  resident_pages_.clear();
+  for (auto page_id : target) {
+    if (bpm_->PinResident(page_id)) {
+      resident_pages_.push_back(page_id);
+    }
+  }
+}
+
+/*****************************************************************************
+ * UPDATE
+ *****************************************************************************/
+/*
+ * Descend to the leaf page that may contain the key, write-latching one page
+ * at a time. Only for in-place modification of a leaf entry.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchLeafWrite(const KeyType &key, page_id_t root_page_id) -> WritePageGuard {
+  auto cur_guard = bpm_->FetchPageWrite(root_page_id);
+  auto cur_page = cur_guard.As<InternalPage>();
+  while (!cur_page->IsLeafPage()) {
+    auto pos = cur_page->UpperBound(key, comparator_) - 1;
+    cur_guard = bpm_->FetchPageWrite(cur_page->ValueAt(pos));
+    cur_page = cur_guard.As<InternalPage>();
+  }
+  return cur_guard;
+}
+
+/*
+ * Overwrite the value associated with key in place.
+ * @return: false if the key does not exist.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Update(const KeyType &key, const ValueType &value) -> bool {
+  if (resident_stale_) {
+    RefreshResident();
+  }
+  auto root_page_id = GetRootPageId();
+  if (root_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  auto leaf_guard = FetchLeafWrite(key, root_page_id);
+  auto leaf_page = leaf_guard.template As<LeafPage>();
+  auto pos = leaf_page->LowerBound(key, comparator_);
+  if (pos >= leaf_page->GetSize() || leaf_page->KeyAt(pos) != key) {
+    return false;
+  }
+  leaf_guard.template AsMut<LeafPage>()->SetKeyValue(pos, key, value);
+  return true;
+}
+
+/*
+ * Insert key & value pair, or overwrite the value if the key already exists.
+ * @return: true if a new entry is inserted.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::InsertOrAssign(const KeyType &key, const ValueType &value) -> bool {
+  auto slot = GetOrInsert(key, value);
+  if (!slot.inserted_) {
+    *slot.value_ = value;
+  }
+  return slot.inserted_;
+}
+
+/*
+ * Return a writable slot holding the value associated with key, inserting
+ * (key, value) first if the key does not exist. When the key is absent and the
+ * leaf has room, the entry is inserted into the leaf reached by the lookup, so
+ * only a leaf split costs another descent.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetOrInsert(const KeyType &key, const ValueType &value) -> ValueSlot {
+  if (resident_stale_) {
+    RefreshResident();
+  }
+  ValueSlot slot;
+  auto root_page_id = GetRootPageId();
+  if (root_page_id != INVALID_PAGE_ID) {
+    slot.guard_ = FetchLeafWrite(key, root_page_id);
+    auto leaf_page = slot.guard_.template AsMut<LeafPage>();
+    auto pos = leaf_page->LowerBound(key, comparator_);
+    if (pos < leaf_page->GetSize() && leaf_page->KeyAt(pos) == key) {
+      slot.value_ = &leaf_page->ValueRefAt(pos);
+      return slot;
+    }
+    if (leaf_page->GetSize() < leaf_max_size_) {
+      for (int i = leaf_page->GetSize() - 1; i >= pos; --i) {
+        leaf_page->SetKeyValue(i + 1, leaf_page->KeyAt(i), leaf_page->ValueAt(i));
+      }
+      leaf_page->SetKeyValue(pos, key, value);
+      leaf_page->IncreaseSize(1);
+      slot.value_ = &leaf_page->ValueRefAt(pos);
+      slot.inserted_ = true;
+      return slot;
+    }
+    slot.guard_.Drop();
+  }
+  Insert(key, value);
+  slot.guard_ = FetchLeafWrite(key, GetRootPageId());
+  auto leaf_page = slot.guard_.template AsMut<LeafPage>();
+  slot.value_ = &leaf_page->ValueRefAt(leaf_page->LowerBound(key, comparator_));
+  slot.inserted_ = true;
+  return slot;
+}
+
+/*****************************************************************************
+ * NON-UNIQUE KEYS
+ *****************************************************************************/
+/*
+ * Insert value into the posting list associated with key. If the key does not
+ * exist yet, a new entry holding a one-value posting list is inserted.
+ * @return: false if the value is already associated with key.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::InsertEntry(const KeyType &key, const EntryType &value) -> bool
+  requires PostingTraits<ValueType>::is_posting_list {
+  if (resident_stale_) {
+    RefreshResident();
+  }
+  auto root_page_id = GetRootPageId();
+  if (root_page_id != INVALID_PAGE_ID) {
+    auto leaf_guard = FetchLeafWrite(key, root_page_id);
+    auto leaf_page = leaf_guard.template As<LeafPage>();
+    auto pos = leaf_page->LowerBound(key, comparator_);
+    if (pos < leaf_page->GetSize() && leaf_page->KeyAt(pos) == key) {
+      auto list = leaf_page->ValueAt(pos);
+      if (!list.Insert(bpm_.get(), value)) {
+        return false;
+      }
+      leaf_guard.template AsMut<LeafPage>()->SetKeyValue(pos, key, list);
+      return true;
+    }
+  }
+  return Insert(key, ValueType(value));
+}
+
+/*
+ * Remove value from the posting list associated with key. The key itself is
+ * removed from the tree together with its last value.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemoveEntry(const KeyType &key, const EntryType &value)
+  requires PostingTraits<ValueType>::is_posting_list {
+  if (resident_stale_) {
+    RefreshResident();
+  }
+  auto root_page_id = GetRootPageId();
+  if (root_page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  auto leaf_guard = FetchLeafWrite(key, root_page_id);
+  auto leaf_page = leaf_guard.template As<LeafPage>();
+  auto pos = leaf_page->LowerBound(key, comparator_);
+  if (pos >= leaf_page->GetSize() || leaf_page->KeyAt(pos) != key) {
+    return;
+  }
+  auto list = leaf_page->ValueAt(pos);
+  if (!list.Remove(bpm_.get(), value)) {
+    return;
+  }
+  if (list.Size() == 0) {
+    RemoveAt(leaf_guard.template AsMut<LeafPage>(), key, pos);
+    if (sparse_keys_.size() >= BPLUSTREE_COMPACT_BATCH) {
+      leaf_guard.Drop();
+      Compact();
+    }
+    return;
+  }
+  leaf_guard.template AsMut<LeafPage>()->SetKeyValue(pos, key, list);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetAll(const KeyType &key, vector<EntryType> *result) -> bool
+  requires PostingTraits<ValueType>::is_posting_list {
+  auto list = Find(key);
+  if (!list.has_value()) {
+    return false;
+  }
+  list->GetAll(bpm_.get(), result);
+  return true;
+}
+
 /*****************************************************************************
  * INDEX ITERATOR
  *****************************************************************************/
@@ -530,6 +781,9 @@ void BPLUSTREE_TYPE::RemoveInternal(const KeyType &key, Context &ctx, int ch) {
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
   auto cur = GetRootPageId();
+  if (cur == INVALID_PAGE_ID) {
+    return {};
+  }
   auto cur_guard = bpm_->FetchPageRead(cur);
   auto cur_page = cur_guard.template As<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
   while (!cur_page->IsLeafPage()) {
@@ -538,7 +792,7 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
     cur_guard = std::move(tmp_guard);
     cur_page = cur_guard.template As<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
   }
-  return INDEXITERATOR_TYPE(bpm_, std::move(cur_guard), 0);
+  return INDEXITERATOR_TYPE(bpm_.get(), std::move(cur_guard), 0);
 }
 
 /*
@@ -549,6 +803,9 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
   auto cur = GetRootPageId();
+  if (cur == INVALID_PAGE_ID) {
+    return {};
+  }
   auto cur_guard = bpm_->FetchPageRead(cur);
   auto cur_page = cur_guard.template As<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
   while (!cur_page->IsLeafPage()) {
@@ -560,7 +817,7 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
   }
   auto leaf_page = cur_guard.template As<B_PLUS_TREE_LEAF_PAGE_TYPE>();
   auto pos = leaf_page->LowerBound(key, comparator_);
-  return INDEXITERATOR_TYPE(bpm_, std::move(cur_guard), pos);
+  return INDEXITERATOR_TYPE(bpm_.get(), std::move(cur_guard), pos);
 }
 
 /*
@@ -570,16 +827,75 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE {
-  auto cur = GetRootPageId();
-  auto cur_guard = bpm_->FetchPageRead(cur);
-  auto cur_page = cur_guard.template As<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
-  while (!cur_page->IsLeafPage()) {
-    cur = cur_page->ValueAt(cur_page->GetSize() - 1);
-    auto tmp_guard = bpm_->FetchPageRead(cur);
-    cur_guard = std::move(tmp_guard);
-    cur_page = cur_guard.template As<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>>();
+  return {};
+}
+
+/*****************************************************************************
+ * STATISTICS
+ *****************************************************************************/
+/*
+ * Visit the tree level by level from the root. Children are pushed in key
+ * order, so the leaf level is visited in key order as well, which is what
+ * leaf_runs_ is counted against.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::Stats() -> BPlusTreeStats {
+  BPlusTreeStats stats;
+  auto root_page_id = GetRootPageId();
+  if (root_page_id == INVALID_PAGE_ID) {
+    return stats;
+  }
+  double fill_sum = 0;
+  int fill_cnt = 0;
+  stats.min_fill_ = 1;
+  page_id_t last_leaf = INVALID_PAGE_ID;
+  vector<page_id_t> level;
+  level.push_back(root_page_id);
+  while (!level.empty()) {
+    ++stats.height_;
+    stats.level_pages_.push_back(static_cast<int>(level.size()));
+    vector<page_id_t> next_level;
+    for (auto page_id : level) {
+      auto cur_guard = bpm_->FetchPageRead(page_id);
+      auto cur_page = cur_guard.template As<BPlusTreePage>();
+      auto size = cur_page->GetSize();
+      if (cur_page->IsLeafPage()) {
+        ++stats.leaves_;
+        stats.entries_ += size;
+        stats.wasted_bytes_ += BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE - size * (sizeof(KeyType) + sizeof(ValueType));
+        if (last_leaf == INVALID_PAGE_ID || page_id != last_leaf + 1) {
+          ++stats.leaf_runs_;
+        }
+        last_leaf = page_id;
+      } else {
+        auto internal_page = cur_guard.template As<InternalPage>();
+        for (int i = 0; i < size; ++i) {
+          next_level.push_back(internal_page->ValueAt(i));
+        }
+        stats.wasted_bytes_ += BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE - size * sizeof(pair<KeyType, page_id_t>);
+      }
+      if (page_id != root_page_id || cur_page->IsLeafPage()) {
+        auto fill = static_cast<double>(size) / cur_page->GetMaxSize();
+        fill_sum += fill;
+        ++fill_cnt;
+        stats.min_fill_ = std::min(stats.min_fill_, fill);
+      }
+    }
+    level = next_level;
   }
-  return INDEXITERATOR_TYPE(bpm_, std::move(cur_guard), cur_page->GetSize());
+  stats.avg_fill_ = fill_sum / fill_cnt;
+  return stats;
+}
+
+std::ostream &operator<<(std::ostream &os, const BPlusTreeStats &stats) {
+  os << "height " << stats.height_ << " pages";
+  for (size_t i = 0; i < stats.level_pages_.size(); ++i) {
+    os << (i == 0 ? " " : "/") << stats.level_pages_[i];
+  }
+  os << " entries " << stats.entries_ << " fill " << static_cast<int>(stats.avg_fill_ * 100) << "%/"
+     << static_cast<int>(stats.min_fill_ * 100) << "% leaves " << stats.leaves_ << " runs " << stats.leaf_runs_
+     << " wasted " << stats.wasted_bytes_;
+  return os;
 }
 
 /**
@@ -597,8 +913,8 @@ void BPLUSTREE_TYPE::SetRootPageId(page_id_t id) {
   page.AsMut<BPlusTreeHeaderPage>()->root_page_id_ = id;
 }
 
-template class BPlusTree<pair<unsigned long long, RID>, RID, std::less<>>;
 template class BPlusTree<unsigned long long, RID, std::less<>>;
-template class BPlusTree<pair<unsigned long long, Date>, page_id_t, std::less<>>;
-template class BPlusTree<pair<unsigned long long, Date>, RID, std::less<>>;
+template class BPlusTree<HashDateKey, page_id_t, std::less<>>;
+template class BPlusTree<HashDateKey, RID, std::less<>>;
 template class BPlusTree<unsigned long long, page_id_t, std::less<>>;
+template class BPlusTree<unsigned long long, PostingList<TrainStop>, std::less<>>;
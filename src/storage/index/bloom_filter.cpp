@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <cstring>
+
+#include "storage/index/bloom_filter.h"
+#include "storage/page/bloom_filter_page.h"
+
+BloomFilter::~BloomFilter() { delete[] bits_; }
+
+void BloomFilter::Reset(uint32_t capacity) {
+  delete[] bits_;
+  capacity_ = capacity;
+  num_words_ = (static_cast<uint64_t>(capacity) * BLOOM_FILTER_BITS_PER_KEY + 63) / 64;
+  bits_ = new uint64_t[num_words_]{};
+  is_dirty_ = true;
+}
+
+/*
+ * The probe positions are derived from the two halves of the hash by double
+ * hashing, h1 + i * h2.
+ */
+void BloomFilter::Add(uint64_t hash) {
+  auto num_bits = static_cast<uint64_t>(num_words_) * 64;
+  auto h1 = hash & 0xffffffffULL;
+  auto h2 = (hash >> 32) | 1;
+  for (int i = 0; i < BLOOM_FILTER_NUM_HASHES; ++i) {
+    auto bit = (h1 + i * h2) % num_bits;
+    bits_[bit >> 6] |= 1ULL << (bit & 63);
+  }
+  is_dirty_ = true;
+}
+
+auto BloomFilter::MayContain(uint64_t hash) const -> bool {
+  auto num_bits = static_cast<uint64_t>(num_words_) * 64;
+  auto h1 = hash & 0xffffffffULL;
+  auto h2 = (hash >> 32) | 1;
+  for (int i = 0; i < BLOOM_FILTER_NUM_HASHES; ++i) {
+    auto bit = (h1 + i * h2) % num_bits;
+    if ((bits_[bit >> 6] & (1ULL << (bit & 63))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void BloomFilter::Load(BufferPoolManager *bpm, page_id_t first_page_id, uint32_t capacity) {
+  Reset(capacity);
+  uint32_t offset = 0;
+  auto cur = first_page_id;
+  while (offset < num_words_ && cur != INVALID_PAGE_ID) {
+    auto cur_guard = bpm->FetchPageRead(cur);
+    auto cur_page = cur_guard.As<BloomFilterPage>();
+    auto cnt = std::min<uint32_t>(BLOOM_FILTER_PAGE_WORDS, num_words_ - offset);
+    memcpy(bits_ + offset, cur_page->words_, sizeof(uint64_t) * cnt);
+    offset += cnt;
+    cur = cur_page->next_page_id_;
+  }
+  is_dirty_ = false;
+}
+
+auto BloomFilter::Save(BufferPoolManager *bpm, page_id_t first_page_id) -> page_id_t {
+  if (first_page_id == INVALID_PAGE_ID) {
+    auto new_guard = bpm->NewPageGuarded(&first_page_id);
+    new_guard.AsMut<BloomFilterPage>()->next_page_id_ = INVALID_PAGE_ID;
+  }
+  uint32_t offset = 0;
+  auto cur_guard = bpm->FetchPageWrite(first_page_id);
+  while (true) {
+    auto cur_page = cur_guard.AsMut<BloomFilterPage>();
+    auto cnt = std::min<uint32_t>(BLOOM_FILTER_PAGE_WORDS, num_words_ - offset);
+    memcpy(cur_page->words_, bits_ + offset, sizeof(uint64_t) * cnt);
+    offset += cnt;
+    if (offset == num_words_) {
+      break;
+    }
+    if (cur_page->next_page_id_ == INVALID_PAGE_ID) {
+      auto new_guard = bpm->NewPageGuarded(&cur_page->next_page_id_);
+      new_guard.AsMut<BloomFilterPage>()->next_page_id_ = INVALID_PAGE_ID;
+    }
+    cur_guard = bpm->FetchPageWrite(cur_page->next_page_id_);
+  }
+  is_dirty_ = false;
+  return first_page_id;
+}
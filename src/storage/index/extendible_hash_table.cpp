@@ -0,0 +1,539 @@
+#include "common/rid.h"
+#include "storage/index/extendible_hash_table.h"
+#include "user/user_profile.h"
+
+HTABLE_TEMPLATE_ARGUMENTS
+EXTENDIBLE_HASH_TABLE_TYPE::ExtendibleHashTable(shared_ptr<BufferPoolManager> buffer_pool_manager,
+                                                uint32_t bloom_capacity, uint32_t header_max_depth, uint32_t directory_max_depth,
+                                                uint32_t bucket_max_size)
+  : bpm_(std::move(buffer_pool_manager)),
+    directory_max_depth_(directory_max_depth),
+    bucket_max_size_(bucket_max_size),
+    header_page_id_(0) {
+  if (bpm_->IsFirstVisit()) {
+    BasicPageGuard guard = bpm_->NewPageGuarded(&header_page_id_);
+    auto root_page = guard.AsMut<BPlusTreeHeaderPage>();
+    root_page->tuple_page_id_ = INVALID_PAGE_ID;
+    root_page->dynamic_page_id_ = INVALID_PAGE_ID;
+    root_page->fsm_page_id_ = INVALID_PAGE_ID;
+    auto htable_guard = bpm_->NewPageGuarded(&htable_header_page_id_);
+    htable_guard.template AsMut<HeaderPage>()->Init(header_max_depth);
+    root_page->root_page_id_ = htable_header_page_id_;
+  } else {
+    auto guard = bpm_->FetchPageRead(header_page_id_);
+    htable_header_page_id_ = guard.As<BPlusTreeHeaderPage>()->root_page_id_;
+  }
+  // The header pages and the directories are touched by every operation, keep them resident if possible.
+  bpm_->PinResident(header_page_id_);
+  bpm_->PinResident(htable_header_page_id_);
+  vector<page_id_t> directories;
+  {
+    auto header_guard = bpm_->FetchPageRead(htable_header_page_id_);
+    auto header_page = header_guard.template As<HeaderPage>();
+    for (uint32_t i = 0; i < header_page->MaxSize(); ++i) {
+      if (header_page->GetDirectoryPageId(i) != INVALID_PAGE_ID) {
+        directories.push_back(header_page->GetDirectoryPageId(i));
+      }
+    }
+  }
+  for (auto directory_page_id : directories) {
+    bpm_->PinResident(directory_page_id);
+  }
+  OpenBloomFilter(bloom_capacity);
+}
+
+HTABLE_TEMPLATE_ARGUMENTS
+EXTENDIBLE_HASH_TABLE_TYPE::~ExtendibleHashTable() {
+  if (!bloom_.Enabled()) {
+    return;
+  }
+  if (bloom_.IsDirty()) {
+    bloom_meta_.page_id_ = bloom_.Save(bpm_.get(), bloom_meta_.page_id_);
+  }
+  WriteBloomMeta();
+}
+
+/*
+ * Keys such as string hashes carry little entropy in their low bits, so the
+ * hash is passed through the 64-bit murmur3 finalizer before it is truncated.
+ */
+HTABLE_TEMPLATE_ARGUMENTS
+auto EXTENDIBLE_HASH_TABLE_TYPE::Hash64(const KeyType &key) const -> uint64_t {
+  auto hash = static_cast<uint64_t>(std::hash<KeyType>()(key));
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+/*****************************************************************************
+ * BLOOM FILTER
+ *****************************************************************************/
+/*
+ * The header page only holds a valid capacity while the table is closed: it
+ * is cleared on open and written back on destruction, so a filter that missed
+ * insertions because the process did not shut down cleanly is never loaded.
+ * A filter is also rebuilt once the table outgrew it, or once a quarter of its
+ * capacity has been removed and only answers "maybe" for those keys. While
+ * the table is open, OnInsert rebuilds a filter the table outgrows.
+ */
+HTABLE_TEMPLATE_ARGUMENTS
+void EXTENDIBLE_HASH_TABLE_TYPE::OpenBloomFilter(uint32_t bloom_capacity) {
+  {
+    auto header_guard = bpm_->FetchPageRead(htable_header_page_id_);
+    bloom_meta_ = header_guard.template As<HeaderPage>()->GetBloomMeta();
+  }
+  auto capacity = bloom_meta_.capacity_;
+  bloom_meta_.capacity_ = 0;
+  WriteBloomMeta();
+  if (bloom_capacity == 0) {
+    return;
+  }
+  if (capacity == 0 || bloom_meta_.page_id_ == INVALID_PAGE_ID || bloom_meta_.num_keys_ > capacity ||
+      bloom_meta_.num_removed_ > capacity / 4) {
+    RebuildBloomFilter(std::max(bloom_capacity, bloom_meta_.num_keys_ * 2));
+  } else {
+    bloom_.Load(bpm_.get(), bloom_meta_.page_id_, capacity);
+  }
+}
+
+HTABLE_TEMPLATE_ARGUMENTS
+void EXTENDIBLE_HASH_TABLE_TYPE::RebuildBloomFilter(uint32_t capacity) {
+  bloom_.Reset(capacity);
+  bloom_meta_.num_keys_ = 0;
+  bloom_meta_.num_removed_ = 0;
+  vector<page_id_t> directories;
+  {
+    auto header_guard = bpm_->FetchPageRead(htable_header_page_id_);
+    auto header_page = header_guard.template As<HeaderPage>();
+    for (uint32_t i = 0; i < header_page->MaxSize(); ++i) {
+      if (header_page->GetDirectoryPageId(i) != INVALID_PAGE_ID) {
+        directories.push_back(header_page->GetDirectoryPageId(i));
+      }
+    }
+  }
+  for (auto directory_page_id : directories) {
+    auto directory_guard = bpm_->FetchPageRead(directory_page_id);
+    auto directory_page = directory_guard.template As<DirectoryPage>();
+    for (uint32_t i = 0; i < directory_page->Size(); ++i) {
+      // Visit every bucket once, through the lowest slot pointing to it.
+      if ((i & directory_page->GetLocalDepthMask(i)) != i) {
+        continue;
+      }
+      for (auto page_id = directory_page->GetBucketPageId(i); page_id != INVALID_PAGE_ID;) {
+        auto bucket_guard = bpm_->FetchPageRead(page_id);
+        auto bucket_page = bucket_guard.template As<BucketPage>();
+        for (uint32_t j = 0; j < bucket_page->Size(); ++j) {
+          bloom_.Add(Hash64(bucket_page->KeyAt(j)));
+        }
+        bloom_meta_.num_keys_ += bucket_page->Size();
+        page_id = bucket_page->OverflowPageId();
+      }
+    }
+  }
+}
+
+/*
+ * A registration burst can outgrow the filter long before the table is
+ * reopened, so it is rebuilt at twice the key count as soon as the keys
+ * exceed its capacity. The rebuild reads every bucket, which the doubling
+ * amortizes to a constant per insertion. The new key is already in its
+ * bucket, so the rebuild picks it up.
+ */
+HTABLE_TEMPLATE_ARGUMENTS
+void EXTENDIBLE_HASH_TABLE_TYPE::OnInsert(uint64_t hash64) {
+  ++bloom_meta_.num_keys_;
+  if (!bloom_.Enabled()) {
+    return;
+  }
+  if (bloom_meta_.num_keys_ > bloom_.Capacity()) {
+    RebuildBloomFilter(bloom_meta_.num_keys_ * 2);
+  } else {
+    bloom_.Add(hash64);
+  }
+}
+
+HTABLE_TEMPLATE_ARGUMENTS
+void EXTENDIBLE_HASH_TABLE_TYPE::WriteBloomMeta() {
+  auto header_guard = bpm_->FetchPageWrite(htable_header_page_id_);
+  auto meta = bloom_meta_;
+  if (bloom_.Enabled()) {
+    meta.capacity_ = bloom_.Capacity();
+  }
+  header_guard.template AsMut<HeaderPage>()->SetBloomMeta(meta);
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+HTABLE_TEMPLATE_ARGUMENTS
+auto EXTENDIBLE_HASH_TABLE_TYPE::FetchDirectoryPageId(uint32_t hash) -> page_id_t {
+  auto header_guard = bpm_->FetchPageRead(htable_header_page_id_);
+  auto header_page = header_guard.template As<HeaderPage>();
+  return header_page->GetDirectoryPageId(header_page->HashToDirectoryIndex(hash));
+}
+
+HTABLE_TEMPLATE_ARGUMENTS
+auto EXTENDIBLE_HASH_TABLE_TYPE::GetValue(const KeyType &key, vector<ValueType> *result) -> bool {
+  auto value = Find(key);
+  if (!value.has_value()) {
+    return false;
+  }
+  result->push_back(*value);
+  return true;
+}
+
+HTABLE_TEMPLATE_ARGUMENTS
+auto EXTENDIBLE_HASH_TABLE_TYPE::Find(const KeyType &key) -> std::optional<ValueType> {
+  auto hash64 = Hash64(key);
+  if (bloom_.Enabled() && !bloom_.MayContain(hash64)) {
+    return std::nullopt;
+  }
+  auto hash = static_cast<uint32_t>(hash64);
+  auto directory_page_id = FetchDirectoryPageId(hash);
+  if (directory_page_id == INVALID_PAGE_ID) {
+    return std::nullopt;
+  }
+  auto directory_guard = bpm_->FetchPageRead(directory_page_id);
+  auto directory_page = directory_guard.template As<DirectoryPage>();
+  auto bucket_guard = bpm_->FetchPageRead(directory_page->GetBucketPageId(directory_page->HashToBucketIndex(hash)));
+  directory_guard.Drop();
+  while (true) {
+    auto bucket_page = bucket_guard.template As<BucketPage>();
+    auto pos = bucket_page->Lookup(key);
+    if (pos != -1) {
+      return bucket_page->ValueAt(pos);
+    }
+    if (bucket_page->OverflowPageId() == INVALID_PAGE_ID) {
+      return std::nullopt;
+    }
+    bucket_guard = bpm_->FetchPageRead(bucket_page->OverflowPageId());
+  }
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+HTABLE_TEMPLATE_ARGUMENTS
+auto EXTENDIBLE_HASH_TABLE_TYPE::Insert(const KeyType &key, const ValueType &value) -> bool {
+  return GetOrInsert(key, value).inserted_;
+}
+
+/*
+ * Create a directory with global depth 0 and a single empty bucket.
+ */
+HTABLE_TEMPLATE_ARGUMENTS
+auto EXTENDIBLE_HASH_TABLE_TYPE::NewDirectory(page_id_t *directory_page_id) -> BasicPageGuard {
+  auto directory_guard = bpm_->NewPageGuarded(directory_page_id);
+  auto directory_page = directory_guard.template AsMut<DirectoryPage>();
+  directory_page->Init(directory_max_depth_);
+  page_id_t bucket_page_id;
+  auto bucket_guard = bpm_->NewPageGuarded(&bucket_page_id);
+  bucket_guard.template AsMut<BucketPage>()->Init(bucket_max_size_);
+  directory_page->SetBucketPageId(0, bucket_page_id);
+  return directory_guard;
+}
+
+/*
+ * Split the bucket at bucket_idx: slots agreeing with it on the lower
+ * local_depth + 1 bits keep the old page, their split images get a new one,
+ * and the entries are redistributed by that bit. bucket_guard is replaced by
+ * nothing, the caller looks the bucket up again.
+ * @return: false if the directory is already at its max depth.
+ */
+HTABLE_TEMPLATE_ARGUMENTS
+auto EXTENDIBLE_HASH_TABLE_TYPE::SplitBucket(DirectoryPage *directory, uint32_t bucket_idx,
+                                             WritePageGuard &bucket_guard) -> bool {
+  auto local_depth = directory->GetLocalDepth(bucket_idx);
+  if (local_depth == directory->GetGlobalDepth()) {
+    if (directory->GetGlobalDepth() == directory->GetMaxDepth()) {
+      return false;
+    }
+    directory->IncrGlobalDepth();
+  }
+  auto old_page_id = bucket_guard.PageId();
+  auto old_page = bucket_guard.template AsMut<BucketPage>();
+  page_id_t new_page_id;
+  auto new_guard = bpm_->NewPageGuarded(&new_page_id);
+  auto new_page = new_guard.template AsMut<BucketPage>();
+  new_page->Init(bucket_max_size_);
+  for (uint32_t i = 0; i < directory->Size(); ++i) {
+    if (directory->GetBucketPageId(i) == old_page_id) {
+      directory->SetLocalDepth(i, local_depth + 1);
+      if ((i >> local_depth) & 1) {
+        directory->SetBucketPageId(i, new_page_id);
+      }
+    }
+  }
+  uint32_t i = 0;
+  while (i < old_page->Size()) {
+    if ((Hash(old_page->KeyAt(i)) >> local_depth) & 1) {
+      new_page->Append(old_page->KeyAt(i), old_page->ValueAt(i));
+      old_page->RemoveAt(i);
+    } else {
+      ++i;
+    }
+  }
+  bucket_guard.Drop();
+  return true;
+}
+
+/*
+ * Return a writable slot holding the value associated with key, inserting
+ * (key, value) first if the key does not exist. Full buckets are split until
+ * the target bucket has room, and a bucket that can not split any more grows
+ * an overflow chain.
+ */
+HTABLE_TEMPLATE_ARGUMENTS
+auto EXTENDIBLE_HASH_TABLE_TYPE::GetOrInsert(const KeyType &key, const ValueType &value) -> ValueSlot {
+  ValueSlot slot;
+  auto hash64 = Hash64(key);
+  auto hash = static_cast<uint32_t>(hash64);
+  auto header_guard = bpm_->FetchPageWrite(htable_header_page_id_);
+  auto header_page = header_guard.template As<HeaderPage>();
+  auto directory_idx = header_page->HashToDirectoryIndex(hash);
+  auto directory_page_id = header_page->GetDirectoryPageId(directory_idx);
+  if (directory_page_id == INVALID_PAGE_ID) {
+    NewDirectory(&directory_page_id);
+    header_guard.template AsMut<HeaderPage>()->SetDirectoryPageId(directory_idx, directory_page_id);
+    header_guard.Drop();
+    bpm_->PinResident(directory_page_id);
+  } else {
+    header_guard.Drop();
+  }
+  auto directory_guard = bpm_->FetchPageWrite(directory_page_id);
+  auto directory_page = directory_guard.template AsMut<DirectoryPage>();
+  while (true) {
+    auto bucket_idx = directory_page->HashToBucketIndex(hash);
+    slot.guard_ = bpm_->FetchPageWrite(directory_page->GetBucketPageId(bucket_idx));
+    auto bucket_page = slot.guard_.template AsMut<BucketPage>();
+    auto pos = bucket_page->Lookup(key);
+    if (pos != -1) {
+      slot.value_ = &bucket_page->ValueRefAt(pos);
+      return slot;
+    }
+    if (!bucket_page->IsFull()) {
+      slot.value_ = &bucket_page->ValueRefAt(bucket_page->Append(key, value));
+      slot.inserted_ = true;
+      OnInsert(hash64);
+      return slot;
+    }
+    if (!SplitBucket(directory_page, bucket_idx, slot.guard_)) {
+      return GetOrInsertOverflow(key, value, hash64, std::move(slot.guard_));
+    }
+  }
+}
+
+/*
+ * Every page of an overflow chain but the last one is full, so a new entry
+ * goes to the last page, or to a new page appended to the chain.
+ */
+HTABLE_TEMPLATE_ARGUMENTS
+auto EXTENDIBLE_HASH_TABLE_TYPE::GetOrInsertOverflow(const KeyType &key, const ValueType &value, uint64_t hash64,
+                                                     WritePageGuard bucket_guard) -> ValueSlot {
+  ValueSlot slot;
+  slot.guard_ = std::move(bucket_guard);
+  while (true) {
+    auto bucket_page = slot.guard_.template AsMut<BucketPage>();
+    auto pos = bucket_page->Lookup(key);
+    if (pos != -1) {
+      slot.value_ = &bucket_page->ValueRefAt(pos);
+      return slot;
+    }
+    if (bucket_page->OverflowPageId() == INVALID_PAGE_ID) {
+      break;
+    }
+    slot.guard_ = bpm_->FetchPageWrite(bucket_page->OverflowPageId());
+  }
+  if (slot.guard_.template As<BucketPage>()->IsFull()) {
+    page_id_t overflow_page_id;
+    bpm_->NewPageGuarded(&overflow_page_id).template AsMut<BucketPage>()->Init(bucket_max_size_);
+    slot.guard_.template AsMut<BucketPage>()->SetOverflowPageId(overflow_page_id);
+    slot.guard_ = bpm_->FetchPageWrite(overflow_page_id);
+  }
+  auto bucket_page = slot.guard_.template AsMut<BucketPage>();
+  slot.value_ = &bucket_page->ValueRefAt(bucket_page->Append(key, value));
+  slot.inserted_ = true;
+  OnInsert(hash64);
+  return slot;
+}
+
+HTABLE_TEMPLATE_ARGUMENTS
+auto EXTENDIBLE_HASH_TABLE_TYPE::InsertOrAssign(const KeyType &key, const ValueType &value) -> bool {
+  auto slot = GetOrInsert(key, value);
+  if (!slot.inserted_ && slot.value_ != nullptr) {
+    *slot.value_ = value;
+  }
+  return slot.inserted_;
+}
+
+/*****************************************************************************
+ * UPDATE
+ *****************************************************************************/
+HTABLE_TEMPLATE_ARGUMENTS
+auto EXTENDIBLE_HASH_TABLE_TYPE::FindForUpdate(const KeyType &key) -> ValueSlot {
+  ValueSlot slot;
+  auto hash64 = Hash64(key);
+  if (bloom_.Enabled() && !bloom_.MayContain(hash64)) {
+    return slot;
+  }
+  auto hash = static_cast<uint32_t>(hash64);
+  auto directory_page_id = FetchDirectoryPageId(hash);
+  if (directory_page_id == INVALID_PAGE_ID) {
+    return slot;
+  }
+  auto directory_guard = bpm_->FetchPageRead(directory_page_id);
+  auto directory_page = directory_guard.template As<DirectoryPage>();
+  slot.guard_ = bpm_->FetchPageWrite(directory_page->GetBucketPageId(directory_page->HashToBucketIndex(hash)));
+  directory_guard.Drop();
+  while (true) {
+    auto bucket_page = slot.guard_.template As<BucketPage>();
+    auto pos = bucket_page->Lookup(key);
+    if (pos != -1) {
+      slot.value_ = &slot.guard_.template AsMut<BucketPage>()->ValueRefAt(pos);
+      return slot;
+    }
+    if (bucket_page->OverflowPageId() == INVALID_PAGE_ID) {
+      slot.guard_.Drop();
+      return slot;
+    }
+    slot.guard_ = bpm_->FetchPageWrite(bucket_page->OverflowPageId());
+  }
+}
+
+HTABLE_TEMPLATE_ARGUMENTS
+auto EXTENDIBLE_HASH_TABLE_TYPE::Update(const KeyType &key, const ValueType &value) -> bool {
+  auto slot = FindForUpdate(key);
+  if (slot.value_ == nullptr) {
+    return false;
+  }
+  *slot.value_ = value;
+  return true;
+}
+
+HTABLE_TEMPLATE_ARGUMENTS
+void EXTENDIBLE_HASH_TABLE_TYPE::Remove(const KeyType &key) {
+  auto hash64 = Hash64(key);
+  if (bloom_.Enabled() && !bloom_.MayContain(hash64)) {
+    return;
+  }
+  auto hash = static_cast<uint32_t>(hash64);
+  auto directory_page_id = FetchDirectoryPageId(hash);
+  if (directory_page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  auto directory_guard = bpm_->FetchPageWrite(directory_page_id);
+  auto directory_page = directory_guard.template AsMut<DirectoryPage>();
+  auto bucket_idx = directory_page->HashToBucketIndex(hash);
+  auto bucket_guard = bpm_->FetchPageWrite(directory_page->GetBucketPageId(bucket_idx));
+  if (bucket_guard.template As<BucketPage>()->OverflowPageId() != INVALID_PAGE_ID) {
+    if (RemoveOverflow(key, std::move(bucket_guard))) {
+      --bloom_meta_.num_keys_;
+      ++bloom_meta_.num_removed_;
+    }
+    return;
+  }
+  auto bucket_page = bucket_guard.template AsMut<BucketPage>();
+  auto pos = bucket_page->Lookup(key);
+  if (pos == -1) {
+    return;
+  }
+  bucket_page->RemoveAt(pos);
+  --bloom_meta_.num_keys_;
+  ++bloom_meta_.num_removed_;
+  if (bucket_page->IsEmpty()) {
+    MergeBucket(directory_page, bucket_idx, std::move(bucket_guard));
+  }
+}
+
+/*
+ * Remove key from the bucket at bucket_guard and its overflow chain. The hole
+ * is filled with the last entry of the chain, so that every page but the last
+ * stays full, and the last page is unlinked and freed once it is empty. The
+ * bucket itself thus never empties while it has a chain.
+ */
+HTABLE_TEMPLATE_ARGUMENTS
+auto EXTENDIBLE_HASH_TABLE_TYPE::RemoveOverflow(const KeyType &key, WritePageGuard bucket_guard) -> bool {
+  vector<page_id_t> chain;
+  int found = -1;
+  int pos = -1;
+  chain.push_back(bucket_guard.PageId());
+  while (true) {
+    auto bucket_page = bucket_guard.template As<BucketPage>();
+    if (found == -1 && (pos = bucket_page->Lookup(key)) != -1) {
+      found = static_cast<int>(chain.size()) - 1;
+    }
+    if (bucket_page->OverflowPageId() == INVALID_PAGE_ID) {
+      break;
+    }
+    chain.push_back(bucket_page->OverflowPageId());
+    bucket_guard = bpm_->FetchPageWrite(chain[chain.size() - 1]);
+  }
+  if (found == -1) {
+    return false;
+  }
+  auto last_page_id = chain[chain.size() - 1];
+  auto last_guard = std::move(bucket_guard);
+  auto last_page = last_guard.template AsMut<BucketPage>();
+  if (chain[found] == last_page_id) {
+    last_page->RemoveAt(pos);
+  } else {
+    auto hole_guard = bpm_->FetchPageWrite(chain[found]);
+    auto hole_page = hole_guard.template AsMut<BucketPage>();
+    auto entry = last_page->EntryAt(last_page->Size() - 1);
+    hole_page->RemoveAt(pos);
+    hole_page->Append(entry.first, entry.second);
+    last_page->RemoveAt(last_page->Size() - 1);
+  }
+  if (last_page->IsEmpty()) {
+    last_guard.Drop();
+    bpm_->FetchPageWrite(chain[chain.size() - 2]).template AsMut<BucketPage>()->SetOverflowPageId(INVALID_PAGE_ID);
+    bpm_->DeletePage(last_page_id);
+  }
+  return true;
+}
+
+/*
+ * Fold an empty bucket into its split image as long as both have the same
+ * local depth, then halve the directory while no bucket needs its full depth.
+ */
+HTABLE_TEMPLATE_ARGUMENTS
+void EXTENDIBLE_HASH_TABLE_TYPE::MergeBucket(DirectoryPage *directory, uint32_t bucket_idx,
+                                             WritePageGuard bucket_guard) {
+  while (directory->GetLocalDepth(bucket_idx) > 0) {
+    auto local_depth = directory->GetLocalDepth(bucket_idx);
+    auto image_idx = directory->GetSplitImageIndex(bucket_idx);
+    if (directory->GetLocalDepth(image_idx) != local_depth) {
+      break;
+    }
+    auto image_guard = bpm_->FetchPageWrite(directory->GetBucketPageId(image_idx));
+    if (!bucket_guard.template As<BucketPage>()->IsEmpty() && !image_guard.template As<BucketPage>()->IsEmpty()) {
+      break;
+    }
+    // Keep whichever of the two buckets is not empty.
+    if (bucket_guard.template As<BucketPage>()->IsEmpty()) {
+      std::swap(bucket_guard, image_guard);
+      std::swap(bucket_idx, image_idx);
+    }
+    auto keep_page_id = bucket_guard.PageId();
+    auto drop_page_id = image_guard.PageId();
+    image_guard.Drop();
+    bpm_->DeletePage(drop_page_id);
+    for (uint32_t i = 0; i < directory->Size(); ++i) {
+      auto page_id = directory->GetBucketPageId(i);
+      if (page_id == keep_page_id || page_id == drop_page_id) {
+        directory->SetBucketPageId(i, keep_page_id);
+        directory->SetLocalDepth(i, local_depth - 1);
+      }
+    }
+  }
+  while (directory->CanShrink()) {
+    directory->DecrGlobalDepth();
+  }
+}
+
+template class ExtendibleHashTable<unsigned long long, RID>;
+template class ExtendibleHashTable<unsigned long long, page_id_t>;
+template class ExtendibleHashTable<unsigned long long, UserProfile>;
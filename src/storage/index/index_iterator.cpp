@@ -3,53 +3,55 @@
  */
 #include "common/rid.h"
 #include "storage/index/index_iterator.h"
+#include "storage/page/posting_page.h"
+#include "ticket/train_stop.h"
 
-#include "common/time.h"
+#include "common/hash_date_key.h"
 
-/*
- * NOTE: you can change the destructor/constructor method here
- * set your own input parameters
- */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator() = default;
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::IndexIterator(shared_ptr<BufferPoolManager> bpm, ReadPageGuard guard, int index)
-  : bpm_(std::move(bpm)), cur_guard_(std::move(guard)), index_(index) {}
+INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *bpm, ReadPageGuard guard, int index)
+  : bpm_(bpm), cur_guard_(std::move(guard)), index_(index) {
+  SkipExhausted();
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::~IndexIterator() = default;
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::IsEnd() -> bool {
-  auto cur_page = cur_guard_.As<B_PLUS_TREE_LEAF_PAGE_TYPE>();
-  return cur_page->GetNextPageId() == INVALID_PAGE_ID && index_ == cur_page->GetSize() - 1;
+void INDEXITERATOR_TYPE::SkipExhausted() {
+  auto cur_page = cur_guard_.template As<B_PLUS_TREE_LEAF_PAGE_TYPE>();
+  while (index_ >= cur_page->GetSize()) {
+    auto next_id = cur_page->GetNextPageId();
+    if (next_id == INVALID_PAGE_ID) {
+      cur_guard_.Drop();
+      bpm_ = nullptr;
+      index_ = 0;
+      return;
+    }
+    cur_guard_ = bpm_->FetchPageRead(next_id);
+    cur_page = cur_guard_.template As<B_PLUS_TREE_LEAF_PAGE_TYPE>();
+    index_ = 0;
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto INDEXITERATOR_TYPE::operator*() -> const MappingType & {
-  auto cur_page = cur_guard_.As<B_PLUS_TREE_LEAF_PAGE_TYPE>();
+auto INDEXITERATOR_TYPE::operator*() -> MappingType {
+  auto cur_page = cur_guard_.template As<B_PLUS_TREE_LEAF_PAGE_TYPE>();
   return cur_page->KeyValueAt(index_);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
-  auto cur_page = cur_guard_.As<B_PLUS_TREE_LEAF_PAGE_TYPE>();
   ++index_;
-  if (index_ >= cur_page->GetSize()) {
-    auto next_id = cur_page->GetNextPageId();
-    if (next_id == INVALID_PAGE_ID) {
-      return *this;
-    }
-    index_ = 0;
-    auto next_guard = bpm_->FetchPageRead(next_id);
-    cur_guard_ = std::move(next_guard);
-  }
+  SkipExhausted();
   return *this;
 }
 
-template class IndexIterator<pair<unsigned long long, RID>, RID, std::less<>>;
 template class IndexIterator<unsigned long long, RID, std::less<>>;
-template class IndexIterator<pair<unsigned long long, Date>, page_id_t, std::less<>>;
+template class IndexIterator<HashDateKey, page_id_t, std::less<>>;
 template class IndexIterator<unsigned long long, int, std::less<>>;
-template class IndexIterator<pair<unsigned long long, Date>, RID, std::less<>>;
+template class IndexIterator<HashDateKey, RID, std::less<>>;
+template class IndexIterator<unsigned long long, PostingList<TrainStop>, std::less<>>;
@@ -1,7 +1,7 @@
 #include "common/rid.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 
-#include "common/time.h"
+#include "common/hash_date_key.h"
 
 /*****************************************************************************
  * HELPER METHODS AND UTILITIES
@@ -77,6 +77,5 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyValue(int index, const KeyType &key,
   array_[index] = make_pair(key, val);
 }
 
-template class BPlusTreeInternalPage<pair<unsigned long long, RID>, page_id_t, std::less<>>;
 template class BPlusTreeInternalPage<unsigned long long, page_id_t, std::less<>>;
-template class BPlusTreeInternalPage<pair<unsigned long long, Date>, page_id_t, std::less<>>;
+template class BPlusTreeInternalPage<HashDateKey, page_id_t, std::less<>>;
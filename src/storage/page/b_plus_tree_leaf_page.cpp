@@ -1,6 +1,8 @@
-#include "common/time.h"
+#include "common/hash_date_key.h"
 #include "common/rid.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/posting_page.h"
+#include "ticket/train_stop.h"
 
 /*****************************************************************************
  * HELPER METHODS AND UTILITIES
@@ -12,6 +14,7 @@
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(int max_size) {
+  static_assert(sizeof(BPlusTreeLeafPage) <= BUSTUB_PAGE_SIZE);
   SetPageType(IndexPageType::LEAF_PAGE);
   SetMaxSize(max_size);
   SetSize(0);
@@ -32,57 +35,69 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_pa
  * array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType { return array_[index].first; }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType { return key_array_[index]; }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType { return array_[index].second; }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType { return value_array_[index]; }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyValueAt(int index) const -> const MappingType & { return array_[index]; }
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueRefAt(int index) -> ValueType & { return value_array_[index]; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyValueAt(int index) const -> MappingType {
+  return make_pair(key_array_[index], value_array_[index]);
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::UpperBound(const KeyType &key, const KeyComparator &cmp) const -> int {
+  if (GetSize() == 0) {
+    return 0;
+  }
   auto l = 0;
   auto r = GetSize() - 1;
-  if (array_[r].first <= key) {
+  if (key_array_[r] <= key) {
     return r + 1;
   }
   while (l + 1 < r) {
     auto mid = (l + r) >> 1;
-    if (array_[mid].first <= key) {
+    if (key_array_[mid] <= key) {
       l = mid;
     } else {
       r = mid;
     }
   }
-  return array_[l].first > key ? l : r;
+  return key_array_[l] > key ? l : r;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::LowerBound(const KeyType &key, const KeyComparator &cmp) const -> int {
+  if (GetSize() == 0) {
+    return 0;
+  }
   auto l = 0;
   auto r = GetSize() - 1;
-  if (array_[r].first < key) {
+  if (key_array_[r] < key) {
     return r + 1;
   }
   while (l + 1 < r) {
     auto mid = (l + r) >> 1;
-    if (array_[mid].first < key) {
+    if (key_array_[mid] < key) {
       l = mid;
     } else {
       r = mid;
     }
   }
-  return array_[l].first >= key ? l : r;
+  return key_array_[l] >= key ? l : r;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::SetKeyValue(int index, const KeyType &key, const ValueType &value) {
-  array_[index] = make_pair(key, value);
+  key_array_[index] = key;
+  value_array_[index] = value;
 }
 
-template class BPlusTreeLeafPage<pair<unsigned long long, RID>, RID, std::less<>>;
 template class BPlusTreeLeafPage<unsigned long long, RID, std::less<>>;
-template class BPlusTreeLeafPage<pair<unsigned long long, Date>, page_id_t, std::less<>>;
-template class BPlusTreeLeafPage<pair<unsigned long long, Date>, RID, std::less<>>;
+template class BPlusTreeLeafPage<HashDateKey, page_id_t, std::less<>>;
+template class BPlusTreeLeafPage<HashDateKey, RID, std::less<>>;
 template class BPlusTreeLeafPage<unsigned long long, page_id_t, std::less<>>;
+template class BPlusTreeLeafPage<unsigned long long, PostingList<TrainStop>, std::less<>>;
@@ -0,0 +1,35 @@
+#include "common/rid.h"
+#include "storage/page/extendible_htable_bucket_page.h"
+#include "user/user_profile.h"
+
+HTABLE_TEMPLATE_ARGUMENTS
+void HTABLE_BUCKET_PAGE_TYPE::Init(uint32_t max_size) {
+  size_ = 0;
+  max_size_ = max_size;
+  overflow_page_id_ = INVALID_PAGE_ID;
+}
+
+HTABLE_TEMPLATE_ARGUMENTS
+auto HTABLE_BUCKET_PAGE_TYPE::Lookup(const KeyType &key) const -> int {
+  for (uint32_t i = 0; i < size_; ++i) {
+    if (array_[i].first == key) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+HTABLE_TEMPLATE_ARGUMENTS
+auto HTABLE_BUCKET_PAGE_TYPE::Append(const KeyType &key, const ValueType &value) -> int {
+  array_[size_] = make_pair(key, value);
+  return static_cast<int>(size_++);
+}
+
+HTABLE_TEMPLATE_ARGUMENTS
+void HTABLE_BUCKET_PAGE_TYPE::RemoveAt(uint32_t index) {
+  array_[index] = array_[--size_];
+}
+
+template class ExtendibleHTableBucketPage<unsigned long long, RID>;
+template class ExtendibleHTableBucketPage<unsigned long long, page_id_t>;
+template class ExtendibleHTableBucketPage<unsigned long long, UserProfile>;
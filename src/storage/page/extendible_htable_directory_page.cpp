@@ -0,0 +1,73 @@
+#include <cstring>
+
+#include "storage/page/extendible_htable_directory_page.h"
+
+void ExtendibleHTableDirectoryPage::Init(uint32_t max_depth) {
+  max_depth_ = max_depth;
+  global_depth_ = 0;
+  memset(local_depths_, 0, sizeof(local_depths_));
+  for (auto &bucket_page_id : bucket_page_ids_) {
+    bucket_page_id = INVALID_PAGE_ID;
+  }
+}
+
+auto ExtendibleHTableDirectoryPage::HashToBucketIndex(uint32_t hash) const -> uint32_t {
+  return hash & GetGlobalDepthMask();
+}
+
+auto ExtendibleHTableDirectoryPage::GetBucketPageId(uint32_t bucket_idx) const -> page_id_t {
+  return bucket_page_ids_[bucket_idx];
+}
+
+void ExtendibleHTableDirectoryPage::SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id) {
+  bucket_page_ids_[bucket_idx] = bucket_page_id;
+}
+
+auto ExtendibleHTableDirectoryPage::GetSplitImageIndex(uint32_t bucket_idx) const -> uint32_t {
+  auto local_depth = local_depths_[bucket_idx];
+  if (local_depth == 0) {
+    return bucket_idx;
+  }
+  return bucket_idx ^ (1U << (local_depth - 1));
+}
+
+auto ExtendibleHTableDirectoryPage::GetGlobalDepth() const -> uint32_t { return global_depth_; }
+
+auto ExtendibleHTableDirectoryPage::GetMaxDepth() const -> uint32_t { return max_depth_; }
+
+auto ExtendibleHTableDirectoryPage::GetGlobalDepthMask() const -> uint32_t { return (1U << global_depth_) - 1; }
+
+auto ExtendibleHTableDirectoryPage::GetLocalDepthMask(uint32_t bucket_idx) const -> uint32_t {
+  return (1U << local_depths_[bucket_idx]) - 1;
+}
+
+void ExtendibleHTableDirectoryPage::IncrGlobalDepth() {
+  auto size = Size();
+  memcpy(local_depths_ + size, local_depths_, sizeof(uint8_t) * size);
+  memcpy(bucket_page_ids_ + size, bucket_page_ids_, sizeof(page_id_t) * size);
+  ++global_depth_;
+}
+
+void ExtendibleHTableDirectoryPage::DecrGlobalDepth() { --global_depth_; }
+
+auto ExtendibleHTableDirectoryPage::CanShrink() const -> bool {
+  if (global_depth_ == 0) {
+    return false;
+  }
+  for (uint32_t i = 0; i < Size(); ++i) {
+    if (local_depths_[i] == global_depth_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto ExtendibleHTableDirectoryPage::Size() const -> uint32_t { return 1U << global_depth_; }
+
+auto ExtendibleHTableDirectoryPage::GetLocalDepth(uint32_t bucket_idx) const -> uint32_t {
+  return local_depths_[bucket_idx];
+}
+
+void ExtendibleHTableDirectoryPage::SetLocalDepth(uint32_t bucket_idx, uint8_t local_depth) {
+  local_depths_[bucket_idx] = local_depth;
+}
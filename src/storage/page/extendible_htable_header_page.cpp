@@ -0,0 +1,26 @@
+#include "storage/page/extendible_htable_header_page.h"
+
+void ExtendibleHTableHeaderPage::Init(uint32_t max_depth) {
+  max_depth_ = max_depth;
+  bloom_meta_ = {INVALID_PAGE_ID, 0, 0, 0};
+  for (auto &directory_page_id : directory_page_ids_) {
+    directory_page_id = INVALID_PAGE_ID;
+  }
+}
+
+auto ExtendibleHTableHeaderPage::HashToDirectoryIndex(uint32_t hash) const -> uint32_t {
+  if (max_depth_ == 0) {
+    return 0;
+  }
+  return hash >> (32 - max_depth_);
+}
+
+auto ExtendibleHTableHeaderPage::GetDirectoryPageId(uint32_t directory_idx) const -> page_id_t {
+  return directory_page_ids_[directory_idx];
+}
+
+void ExtendibleHTableHeaderPage::SetDirectoryPageId(uint32_t directory_idx, page_id_t directory_page_id) {
+  directory_page_ids_[directory_idx] = directory_page_id;
+}
+
+auto ExtendibleHTableHeaderPage::MaxSize() const -> uint32_t { return 1U << max_depth_; }
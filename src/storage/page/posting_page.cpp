@@ -0,0 +1,195 @@
+#include <cstring>
+
+#include "common/rid.h"
+#include "storage/page/posting_page.h"
+#include "ticket/train_stop.h"
+
+template <class T>
+void PostingPage<T>::Init() {
+  size_ = 0;
+  next_page_id_ = INVALID_PAGE_ID;
+}
+
+template <class T>
+int PostingPage<T>::LowerBound(const T &val) const {
+  int l = 0;
+  int r = size_;
+  while (l < r) {
+    auto mid = (l + r) >> 1;
+    if (data_[mid] < val) {
+      l = mid + 1;
+    } else {
+      r = mid;
+    }
+  }
+  return l;
+}
+
+template <class T>
+void PostingPage<T>::InsertAt(int index, const T &val) {
+  memmove(data_ + index + 1, data_ + index, sizeof(T) * (size_ - index));
+  data_[index] = val;
+  ++size_;
+}
+
+template <class T>
+void PostingPage<T>::RemoveAt(int index) {
+  memmove(data_ + index, data_ + index + 1, sizeof(T) * (size_ - index - 1));
+  --size_;
+}
+
+template <class T>
+void PostingPage<T>::MoveHalfTo(PostingPage *other) {
+  auto half = size_ >> 1;
+  memcpy(other->data_, data_ + half, sizeof(T) * (size_ - half));
+  other->size_ = size_ - half;
+  other->next_page_id_ = next_page_id_;
+  size_ = half;
+}
+
+/*
+ * Inline lists are kept sorted in inline_. When an insertion overflows the
+ * inline area, every value is moved into a fresh posting page.
+ */
+template <class T>
+bool PostingList<T>::Insert(BufferPoolManager *bpm, const T &val) {
+  if (IsInline()) {
+    int pos = 0;
+    while (pos < size_ && inline_[pos] < val) {
+      ++pos;
+    }
+    if (pos < size_ && inline_[pos] == val) {
+      return false;
+    }
+    if (size_ < POSTING_INLINE_SIZE) {
+      for (int i = size_; i > pos; --i) {
+        inline_[i] = inline_[i - 1];
+      }
+      inline_[pos] = val;
+      ++size_;
+      return true;
+    }
+    auto new_guard = bpm->NewPageGuarded(&overflow_page_id_);
+    auto new_page = new_guard.AsMut<PostingPage<T>>();
+    new_page->Init();
+    for (int i = 0; i < size_; ++i) {
+      new_page->InsertAt(i, inline_[i]);
+    }
+    new_page->InsertAt(pos, val);
+    ++size_;
+    return true;
+  }
+  auto cur_guard = bpm->FetchPageWrite(overflow_page_id_);
+  auto cur_page = cur_guard.As<PostingPage<T>>();
+  // Find the last page whose first value is not greater than val.
+  while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
+    auto next_guard = bpm->FetchPageWrite(cur_page->GetNextPageId());
+    auto next_page = next_guard.template As<PostingPage<T>>();
+    if (val < next_page->At(0)) {
+      break;
+    }
+    cur_guard = std::move(next_guard);
+    cur_page = next_page;
+  }
+  auto pos = cur_page->LowerBound(val);
+  if (pos < cur_page->Size() && cur_page->At(pos) == val) {
+    return false;
+  }
+  auto mut_page = cur_guard.AsMut<PostingPage<T>>();
+  if (mut_page->Full()) {
+    page_id_t new_id;
+    auto new_guard = bpm->NewPageGuarded(&new_id);
+    auto new_page = new_guard.AsMut<PostingPage<T>>();
+    mut_page->MoveHalfTo(new_page);
+    mut_page->SetNextPageId(new_id);
+    if (pos > mut_page->Size()) {
+      new_page->InsertAt(pos - mut_page->Size(), val);
+      ++size_;
+      return true;
+    }
+  }
+  mut_page->InsertAt(pos, val);
+  ++size_;
+  return true;
+}
+
+/*
+ * Pages that become empty are unlinked from the chain. Once the whole list fits
+ * in a single page that is small enough, it is moved back inline.
+ */
+template <class T>
+bool PostingList<T>::Remove(BufferPoolManager *bpm, const T &val) {
+  if (IsInline()) {
+    int pos = 0;
+    while (pos < size_ && inline_[pos] != val) {
+      ++pos;
+    }
+    if (pos == size_) {
+      return false;
+    }
+    for (int i = pos + 1; i < size_; ++i) {
+      inline_[i - 1] = inline_[i];
+    }
+    --size_;
+    return true;
+  }
+  WritePageGuard prev_guard;
+  bool has_prev = false;
+  auto cur_guard = bpm->FetchPageWrite(overflow_page_id_);
+  auto cur_page = cur_guard.As<PostingPage<T>>();
+  while (cur_page->At(cur_page->Size() - 1) < val) {
+    if (cur_page->GetNextPageId() == INVALID_PAGE_ID) {
+      return false;
+    }
+    prev_guard = std::move(cur_guard);
+    has_prev = true;
+    cur_guard = bpm->FetchPageWrite(cur_page->GetNextPageId());
+    cur_page = cur_guard.As<PostingPage<T>>();
+  }
+  auto pos = cur_page->LowerBound(val);
+  if (cur_page->At(pos) != val) {
+    return false;
+  }
+  auto mut_page = cur_guard.AsMut<PostingPage<T>>();
+  mut_page->RemoveAt(pos);
+  --size_;
+  if (mut_page->Size() == 0) {
+    auto cur = cur_guard.PageId();
+    auto next = mut_page->GetNextPageId();
+    if (!has_prev) {
+      overflow_page_id_ = next;
+    } else {
+      prev_guard.AsMut<PostingPage<T>>()->SetNextPageId(next);
+    }
+    cur_guard.Drop();
+    bpm->DeletePage(cur);
+    return true;
+  }
+  prev_guard.Drop();
+  cur_guard.Drop();
+  if (size_ <= POSTING_INLINE_SIZE) {
+    auto first_guard = bpm->FetchPageRead(overflow_page_id_);
+    auto first_page = first_guard.As<PostingPage<T>>();
+    if (first_page->GetNextPageId() == INVALID_PAGE_ID) {
+      memcpy(inline_, first_page->Data(), sizeof(T) * size_);
+      auto first = overflow_page_id_;
+      overflow_page_id_ = INVALID_PAGE_ID;
+      first_guard.Drop();
+      bpm->DeletePage(first);
+    }
+  }
+  return true;
+}
+
+template <class T>
+void PostingList<T>::GetAll(BufferPoolManager *bpm, vector<T> *result) const {
+  Scan(bpm, [result](const T *values, int count) {
+    for (int i = 0; i < count; ++i) {
+      result->push_back(values[i]);
+    }
+    return true;
+  });
+}
+
+template class PostingPage<TrainStop>;
+template struct PostingList<TrainStop>;
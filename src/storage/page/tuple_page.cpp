@@ -3,9 +3,8 @@
 #include "storage/page/tuple_page.h"
 
 #include "ticket/order_list.h"
-#include "ticket/train_system.h"
+#include "ticket/station_dictionary.h"
 #include "ticket/waitlist.h"
-#include "user/user_system.h"
 
 template <class T>
 T& TuplePage<T>::operator[](std::size_t id) {
@@ -83,28 +82,99 @@ void LinkedTuplePage<T>::SetNextPageId(page_id_t id) {
   next_page_id_ = id;
 }
 
-bool DynamicTuplePage::IsFull(const string& data) const {
-  return size_ + data.size() + 1 > BUSTUB_PAGE_SIZE - DYNAMIC_TUPLE_HEADER_SIZE;
+void DynamicTuplePage::Init() {
+  slot_count_ = 0;
+  record_begin_ = DYNAMIC_TUPLE_DATA_SIZE;
+  garbage_ = 0;
+  unused_ = 0;
 }
 
-int32_t DynamicTuplePage::Append(const string& data) {
-  auto ret = size_;
-  memcpy(data_ + size_, data.c_str(), data.size());
-  size_ += static_cast<int32_t>(data.size());
-  data_[size_++] = '\0';
-  return ret;
+uint32_t DynamicTuplePage::FreeSpace() const {
+  auto free = ContiguousSpace() + garbage_;
+  bool has_free_slot = false;
+  for (int i = 0; i < slot_count_ && !has_free_slot; ++i) {
+    has_free_slot = slots_[i].offset_ == 0;
+  }
+  if (!has_free_slot) {
+    free = free < DYNAMIC_TUPLE_SLOT_SIZE ? 0 : free - DYNAMIC_TUPLE_SLOT_SIZE;
+  }
+  return free;
+}
+
+int32_t DynamicTuplePage::InsertBytes(const char *data, std::size_t size) {
+  int32_t slot = 0;
+  while (slot < slot_count_ && slots_[slot].offset_ != 0) {
+    ++slot;
+  }
+  auto needed = size + (slot == slot_count_ ? DYNAMIC_TUPLE_SLOT_SIZE : 0);
+  if (ContiguousSpace() + garbage_ < needed) {
+    return -1;
+  }
+  if (slot == slot_count_) {
+    if (ContiguousSpace() < DYNAMIC_TUPLE_SLOT_SIZE) {
+      Compact();
+    }
+    ++slot_count_;
+    slots_[slot] = {0, 0};
+  }
+  Allocate(slot, static_cast<uint16_t>(size));
+  memcpy(data_ + slots_[slot].offset_, data, size);
+  return slot;
+}
+
+bool DynamicTuplePage::UpdateBytes(int32_t slot, const char *data, std::size_t size) {
+  auto &cur = slots_[slot];
+  if (size <= cur.size_) {
+    memcpy(data_ + cur.offset_, data, size);
+    garbage_ += cur.size_ - size;
+    cur.size_ = static_cast<uint16_t>(size);
+    return true;
+  }
+  if (ContiguousSpace() + garbage_ + cur.size_ < size) {
+    return false;
+  }
+  garbage_ += cur.size_;
+  cur = {0, 0};
+  Allocate(slot, static_cast<uint16_t>(size));
+  memcpy(data_ + slots_[slot].offset_, data, size);
+  return true;
+}
+
+void DynamicTuplePage::Allocate(int32_t slot, uint16_t size) {
+  if (ContiguousSpace() < size) {
+    Compact();
+  }
+  record_begin_ -= size;
+  slots_[slot] = {record_begin_, size};
+}
+
+void DynamicTuplePage::Delete(int32_t slot) {
+  garbage_ += slots_[slot].size_;
+  slots_[slot] = {0, 0};
+  while (slot_count_ > 0 && slots_[slot_count_ - 1].offset_ == 0) {
+    --slot_count_;
+  }
+  if (slot_count_ == 0) {
+    Init();
+  }
 }
 
-string DynamicTuplePage::At(std::size_t pos) const {
-  string ret{};
-  auto cur = pos;
-  while (data_[cur] != '\0') {
-    ret.push_back(data_[cur++]);
+void DynamicTuplePage::Compact() {
+  char buffer[DYNAMIC_TUPLE_DATA_SIZE];
+  uint16_t end = DYNAMIC_TUPLE_DATA_SIZE;
+  for (int i = 0; i < slot_count_; ++i) {
+    if (slots_[i].offset_ == 0) {
+      continue;
+    }
+    end -= slots_[i].size_;
+    memcpy(buffer + end, data_ + slots_[i].offset_, slots_[i].size_);
+    slots_[i].offset_ = end;
   }
-  return std::move(ret);
+  memcpy(data_ + end, buffer + end, DYNAMIC_TUPLE_DATA_SIZE - end);
+  record_begin_ = end;
+  garbage_ = 0;
 }
 
-template class TuplePage<UserProfile>;
-template class TuplePage<TrainInfo>;
 template class LinkedTuplePage<WaitInfo>;
 template class LinkedTuplePage<OrderInfo>;
+template class LinkedTuplePage<StationName>;
@@ -5,7 +5,7 @@
 
 OrderList::OrderList(shared_ptr<BufferPoolManager> bpm)
  : bpm_(std::move(bpm)),
-   index_(new BPlusTree<unsigned long long, page_id_t, std::less<>>(bpm_, std::less())) {
+   index_(new ExtendibleHashTable<unsigned long long, page_id_t>(bpm_)) {
   auto cur_guard = bpm_->FetchPageRead(0);
   auto cur_page = cur_guard.As<BPlusTreeHeaderPage>();
   next_tuple_id_ = cur_page->tuple_page_id_;
@@ -17,15 +17,14 @@ OrderList::~OrderList() {
   cur_page->tuple_page_id_ = next_tuple_id_;
 }
 
-void OrderList::QueryOrder(const string& username) const {
+void OrderList::QueryOrder(const string& username, const StationDictionary& stations) const {
   using std::cout, std::endl;
-  vector<page_id_t> page_id;
-  index_->GetValue(StringHash(username), &page_id);
-  if (page_id.empty()) {
+  auto page_id = index_->Find(StringHash(username));
+  if (!page_id.has_value()) {
     cout << 0 << endl;
     return;
   }
-  auto cur_guard = bpm_->FetchPageRead(page_id[0]);
+  auto cur_guard = bpm_->FetchPageRead(*page_id);
   auto cur_page = cur_guard.As<LinkedTuplePage<OrderInfo>>();
   vector<OrderInfo> result;
   bool flag = true;
@@ -52,27 +51,26 @@ void OrderList::QueryOrder(const string& username) const {
       case OrderStatus::ksuccess :
         status = "success"; break;
       }
-    cout << "[" << status << "] " << info.train_id_ << " " << info.from_ << " "
-         << info.leave_ << " -> " << info.to_ << " " << info.arrive_ << " "
+    cout << "[" << status << "] " << info.train_id_ << " " << stations.Name(info.from_) << " "
+         << info.leave_ << " -> " << stations.Name(info.to_) << " " << info.arrive_ << " "
          << info.price_ << " " << info.num_ << endl;
   }
 }
 
 void OrderList::QueueSucceed(const string& username, std::size_t timestamp) {
-  vector<page_id_t> page_id;
-  index_->GetValue(StringHash(username), &page_id);
-  auto cur_guard = bpm_->FetchPageWrite(page_id[0]);
+  auto page_id = index_->Find(StringHash(username));
+  auto cur_guard = bpm_->FetchPageWrite(*page_id);
   auto cur_page = cur_guard.As<LinkedTuplePage<OrderInfo>>();
   bool flag = true;
   while (flag) {
-    if (cur_page->At(0).timestamp_ > timestamp) {
+    if (static_cast<std::size_t>(cur_page->At(0).timestamp_) > timestamp) {
       cur_guard = bpm_->FetchPageWrite(cur_page->GetNextPageId());
       cur_page = cur_guard.As<LinkedTuplePage<OrderInfo>>();
     } else {
       flag = false;
       auto tmp_page = cur_guard.AsMut<LinkedTuplePage<OrderInfo>>();
       for (int i = 0; i < tmp_page->Size(); ++i) {
-        if (tmp_page->operator[](i).timestamp_ == timestamp) {
+        if (static_cast<std::size_t>(tmp_page->operator[](i).timestamp_) == timestamp) {
           tmp_page->operator[](i).status_ = OrderStatus::ksuccess;
           break;
         }
@@ -82,11 +80,13 @@ void OrderList::QueueSucceed(const string& username, std::size_t timestamp) {
 }
 
 bool OrderList::RefundTicket(const string& username, std::size_t num, OrderInfo &info) {
-  vector<page_id_t> page_id;
-  index_->GetValue(StringHash(username), &page_id);
-  auto cur_guard = bpm_->FetchPageWrite(page_id[0]);
+  auto page_id = index_->Find(StringHash(username));
+  if (!page_id.has_value()) {
+    return false;
+  }
+  auto cur_guard = bpm_->FetchPageWrite(*page_id);
   auto cur_page = cur_guard.As<LinkedTuplePage<OrderInfo>>();
-  while (cur_page->Size() < num) {
+  while (static_cast<std::size_t>(cur_page->Size()) < num) {
     if (cur_page->GetNextPageId() == INVALID_PAGE_ID) {
       return false;
     }
@@ -105,26 +105,20 @@ bool OrderList::RefundTicket(const string& username, std::size_t num, OrderInfo
 }
 
 void OrderList::AppendOrder(const string &username, const OrderInfo& order_info) {
-  vector<page_id_t> page_id;
-  index_->GetValue(StringHash(username), &page_id);
-  if (page_id.empty()) {
-    page_id_t new_id;
-    auto cur_guard = bpm_->NewPageGuarded(&new_id);
-    auto cur_page = cur_guard.AsMut<LinkedTuplePage<OrderInfo>>();
-    cur_page->SetNextPageId(INVALID_PAGE_ID);
-    cur_page->Append(order_info);
-    index_->Insert(StringHash(username), new_id);
-    return;
+  // A new user starts with an empty head page id, which gets replaced like a full head page.
+  auto head = index_->GetOrInsert(StringHash(username), INVALID_PAGE_ID);
+  WritePageGuard cur_guard;
+  LinkedTuplePage<OrderInfo> *cur_page = nullptr;
+  if (*head.value_ != INVALID_PAGE_ID) {
+    cur_guard = bpm_->FetchPageWrite(*head.value_);
+    cur_page = cur_guard.AsMut<LinkedTuplePage<OrderInfo>>();
   }
-  auto cur_guard = bpm_->FetchPageWrite(page_id[0]);
-  auto cur_page = cur_guard.AsMut<LinkedTuplePage<OrderInfo>>();
-  if (cur_page->Full()) {
+  if (cur_page == nullptr || cur_page->Full()) {
     page_id_t new_id;
     auto new_guard = bpm_->NewPageGuarded(&new_id);
     auto new_page = new_guard.AsMut<LinkedTuplePage<OrderInfo>>();
-    new_page->SetNextPageId(cur_guard.PageId());
-    index_->Remove(StringHash(username));
-    index_->Insert(StringHash(username), new_id);
+    new_page->SetNextPageId(*head.value_);
+    *head.value_ = new_id;
     cur_page = new_page;
   }
   cur_page->Append(order_info);
@@ -0,0 +1,107 @@
+#include "ticket/query_cache.h"
+
+#include <algorithm>
+
+QueryCache::~QueryCache() {
+  while (head_ != nullptr) {
+    auto next = head_->next_;
+    delete head_;
+    head_ = next;
+  }
+}
+
+const string *QueryCache::Find(const QueryKey &key) {
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    ++misses_;
+    return nullptr;
+  }
+  ++hits_;
+  auto entry = it->second;
+  if (entry != head_) {
+    Unlink(entry);
+    PushFront(entry);
+  }
+  return &entry->output_;
+}
+
+void QueryCache::Insert(const QueryKey &key, const string &output, const vector<SeatKey> &seats) {
+  auto entry = new QueryCacheEntry{key, output, seats, nullptr, nullptr};
+  entries_.insert({key, entry});
+  for (size_t i = 0; i < seats.size(); ++i) {
+    readers_[seats[i]].push_back(entry);
+  }
+  PushFront(entry);
+  if (entries_.size() > capacity_) {
+    Drop(tail_);
+  }
+}
+
+void QueryCache::InvalidateStations(const int32_t *stations, int count) {
+  vector<int32_t> sorted;
+  for (int i = 0; i < count; ++i) {
+    sorted.push_back(stations[i]);
+  }
+  sorted.sort();
+  auto through = [&](int32_t station) { return std::binary_search(&sorted[0], &sorted[0] + count, station); };
+  for (auto cur = head_; cur != nullptr;) {
+    auto next = cur->next_;
+    if (through(cur->key_.from_) && through(cur->key_.to_)) {
+      Drop(cur);
+    }
+    cur = next;
+  }
+}
+
+void QueryCache::InvalidateSeats(const SeatKey &seat) {
+  auto it = readers_.find(seat);
+  if (it == readers_.end()) {
+    return;
+  }
+  // Drop edits the list, and erases it with its last entry.
+  auto readers = it->second;
+  for (size_t i = 0; i < readers.size(); ++i) {
+    Drop(readers[i]);
+  }
+}
+
+void QueryCache::Unlink(QueryCacheEntry *entry) {
+  (entry->prev_ != nullptr ? entry->prev_->next_ : head_) = entry->next_;
+  (entry->next_ != nullptr ? entry->next_->prev_ : tail_) = entry->prev_;
+  entry->prev_ = entry->next_ = nullptr;
+}
+
+void QueryCache::PushFront(QueryCacheEntry *entry) {
+  entry->next_ = head_;
+  if (head_ != nullptr) {
+    head_->prev_ = entry;
+  } else {
+    tail_ = entry;
+  }
+  head_ = entry;
+}
+
+void QueryCache::Drop(QueryCacheEntry *entry) {
+  for (size_t i = 0; i < entry->seats_.size(); ++i) {
+    auto it = readers_.find(entry->seats_[i]);
+    auto &readers = it->second;
+    for (size_t j = 0; j < readers.size(); ++j) {
+      if (readers[j] == entry) {
+        readers[j] = readers[readers.size() - 1];
+        readers.pop_back();
+        break;
+      }
+    }
+    if (readers.empty()) {
+      readers_.erase(it);
+    }
+  }
+  entries_.erase(entry->key_);
+  Unlink(entry);
+  delete entry;
+}
+
+std::ostream &operator<<(std::ostream &os, const QueryCache &cache) {
+  os << "hits " << cache.Hits() << " misses " << cache.Misses() << " entries " << cache.Size();
+  return os;
+}
@@ -0,0 +1,72 @@
+#include "ticket/seat_cache.h"
+
+SeatCache::SeatCache(std::size_t budget_bytes) : budget_bytes_(budget_bytes) {}
+
+SeatCache::~SeatCache() {
+  while (head_ != nullptr) {
+    auto next = head_->next_;
+    delete[] head_->seats_;
+    delete head_;
+    head_ = next;
+  }
+}
+
+SeatCacheEntry *SeatCache::Find(const RID &row) {
+  auto it = entries_.find(row);
+  if (it == entries_.end()) {
+    ++misses_;
+    return nullptr;
+  }
+  ++hits_;
+  auto entry = it->second;
+  if (entry != head_) {
+    Unlink(entry);
+    PushFront(entry);
+  }
+  return entry;
+}
+
+SeatCacheEntry *SeatCache::Insert(const RID &row, int8_t station_num, int32_t max_seat) {
+  auto entry = new SeatCacheEntry{row, max_seat, station_num, false, new int32_t[station_num - 1], nullptr, nullptr};
+  entries_.insert({row, entry});
+  PushFront(entry);
+  bytes_ += EntrySize(station_num);
+  return entry;
+}
+
+SeatCacheEntry *SeatCache::EvictOverBudget() {
+  if (bytes_ <= budget_bytes_ || tail_ == nullptr) {
+    return nullptr;
+  }
+  auto entry = tail_;
+  Unlink(entry);
+  entries_.erase(entry->row_);
+  bytes_ -= EntrySize(entry->station_num_);
+  return entry;
+}
+
+void SeatCache::Release(SeatCacheEntry *entry) {
+  delete[] entry->seats_;
+  delete entry;
+}
+
+void SeatCache::Unlink(SeatCacheEntry *entry) {
+  (entry->prev_ != nullptr ? entry->prev_->next_ : head_) = entry->next_;
+  (entry->next_ != nullptr ? entry->next_->prev_ : tail_) = entry->prev_;
+  entry->prev_ = entry->next_ = nullptr;
+}
+
+void SeatCache::PushFront(SeatCacheEntry *entry) {
+  entry->next_ = head_;
+  if (head_ != nullptr) {
+    head_->prev_ = entry;
+  } else {
+    tail_ = entry;
+  }
+  head_ = entry;
+}
+
+std::ostream &operator<<(std::ostream &os, const SeatCache &cache) {
+  os << "hits " << cache.Hits() << " misses " << cache.Misses() << " bytes " << cache.Bytes();
+  return os;
+}
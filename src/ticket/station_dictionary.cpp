@@ -0,0 +1,65 @@
+#include "ticket/station_dictionary.h"
+
+#include "common/utils.h"
+#include "storage/page/b_plus_tree_header_page.h"
+#include "storage/page/tuple_page.h"
+
+StationDictionary::StationDictionary(shared_ptr<BufferPoolManager> bpm) : bpm_(std::move(bpm)) {
+  page_id_t cur;
+  {
+    auto header_guard = bpm_->FetchPageRead(0);
+    cur = header_guard.As<BPlusTreeHeaderPage>()->tuple_page_id_;
+  }
+  while (cur != INVALID_PAGE_ID) {
+    auto cur_guard = bpm_->FetchPageRead(cur);
+    auto cur_page = cur_guard.As<LinkedTuplePage<StationName>>();
+    for (int i = 0; i < cur_page->Size(); ++i) {
+      string name = cur_page->At(i).name_;
+      ids_[StringHash(name)] = static_cast<int32_t>(names_.size());
+      names_.push_back(name);
+    }
+    last_page_id_ = cur;
+    cur = cur_page->GetNextPageId();
+  }
+}
+
+int32_t StationDictionary::Intern(std::string_view name) {
+  auto hash = StringHash(name);
+  auto it = ids_.find(hash);
+  if (it != ids_.end()) {
+    return it->second;
+  }
+  StationName entry;
+  name.copy(entry.name_, sizeof(entry.name_) - 1);
+  if (last_page_id_ == INVALID_PAGE_ID) {
+    {
+      auto new_guard = bpm_->NewPageGuarded(&last_page_id_);
+      new_guard.AsMut<LinkedTuplePage<StationName>>()->SetNextPageId(INVALID_PAGE_ID);
+    }
+    auto header_guard = bpm_->FetchPageWrite(0);
+    header_guard.AsMut<BPlusTreeHeaderPage>()->tuple_page_id_ = last_page_id_;
+  }
+  auto cur_guard = bpm_->FetchPageWrite(last_page_id_);
+  auto cur_page = cur_guard.AsMut<LinkedTuplePage<StationName>>();
+  if (cur_page->Full()) {
+    page_id_t new_page_id;
+    {
+      auto new_guard = bpm_->NewPageGuarded(&new_page_id);
+      new_guard.AsMut<LinkedTuplePage<StationName>>()->SetNextPageId(INVALID_PAGE_ID);
+    }
+    cur_page->SetNextPageId(new_page_id);
+    last_page_id_ = new_page_id;
+    cur_guard = bpm_->FetchPageWrite(last_page_id_);
+    cur_page = cur_guard.AsMut<LinkedTuplePage<StationName>>();
+  }
+  cur_page->Append(entry);
+  auto id = static_cast<int32_t>(names_.size());
+  ids_[hash] = id;
+  names_.push_back(string(name));
+  return id;
+}
+
+int32_t StationDictionary::Find(std::string_view name) const {
+  auto it = ids_.find(StringHash(name));
+  return it == ids_.end() ? -1 : it->second;
+}
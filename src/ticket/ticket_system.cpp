@@ -1,57 +1,175 @@
 #include "ticket/ticket_system.h"
 
-#include "common/utils.h"
+#include <algorithm>
+#include <bit>
+#include <exception>
 
-TicketSystem::TicketSystem(shared_ptr<BufferPoolManager> bpm)
-  : bpm_(std::move(bpm)),
-    index_(new BPlusTree<pair<unsigned long long, Date>, RID, std::less<>>(bpm_, std::less())) {
+#include "storage/page/b_plus_tree_header_page.h"
+
+TicketSystem::TicketSystem(shared_ptr<BufferPoolManager> bpm) : bpm_(std::move(bpm)) {
+  if (bpm_->IsFirstVisit()) {
+    page_id_t header_page_id;
+    auto header_guard = bpm_->NewPageGuarded(&header_page_id);
+    auto header_page = header_guard.AsMut<BPlusTreeHeaderPage>();
+    header_page->root_page_id_ = INVALID_PAGE_ID;
+    header_page->tuple_page_id_ = 0;
+    header_page->dynamic_page_id_ = INVALID_PAGE_ID;
+    header_page->fsm_page_id_ = INVALID_PAGE_ID;
+  }
   auto cur_guard = bpm_->FetchPageRead(0);
   auto cur_page = cur_guard.As<BPlusTreeHeaderPage>();
-  dynamic_page_id_ = cur_page->dynamic_page_id_;
+  tail_page_id_ = cur_page->dynamic_page_id_;
+  tail_used_ = cur_page->tuple_page_id_;
 }
 
 TicketSystem::~TicketSystem() {
+  cache_.ForEach([this](const SeatCacheEntry *entry) {
+    if (entry->dirty_) {
+      WriteBack(entry);
+    }
+  });
   auto cur_guard = bpm_->FetchPageWrite(0);
   auto cur_page = cur_guard.AsMut<BPlusTreeHeaderPage>();
-  cur_page->dynamic_page_id_ = dynamic_page_id_;
+  cur_page->dynamic_page_id_ = tail_page_id_;
+  cur_page->tuple_page_id_ = tail_used_;
+}
+
+// Bits of a seat count of a train with max_seat seats.
+static int CountBits(int32_t max_seat) {
+  return std::max(1, static_cast<int>(std::bit_width(static_cast<uint32_t>(max_seat))));
+}
+
+// Bytes of one row of a seat matrix.
+static int RowSize(int station_num, int32_t max_seat) {
+  return ((station_num - 1) * CountBits(max_seat) + 7) / 8;
+}
+
+// Page and byte offset of the row of the day-th day in the seat matrix at matrix.
+static RID LocateRow(const RID &matrix, int row_size, int day) {
+  auto rows_per_page = static_cast<int>(BUSTUB_PAGE_SIZE) / row_size;
+  return {matrix.page_id_ + day / rows_per_page, matrix.pos_ + day % rows_per_page * row_size};
+}
+
+// Read the seats left on each of the station_num - 1 segments from a packed row of seats sold.
+static void UnpackRow(const char *row, int station_num, int32_t max_seat, int32_t *seats) {
+  auto bits = CountBits(max_seat);
+  auto mask = (1ULL << bits) - 1;
+  uint64_t buffer = 0;
+  int buffered = 0;
+  for (int i = 0; i < station_num - 1; ++i) {
+    while (buffered < bits) {
+      buffer |= static_cast<uint64_t>(static_cast<uint8_t>(*row++)) << buffered;
+      buffered += 8;
+    }
+    seats[i] = max_seat - static_cast<int32_t>(buffer & mask);
+    buffer >>= bits;
+    buffered -= bits;
+  }
+}
+
+static void PackRow(char *row, int station_num, int32_t max_seat, const int32_t *seats) {
+  auto bits = CountBits(max_seat);
+  uint64_t buffer = 0;
+  int buffered = 0;
+  for (int i = 0; i < station_num - 1; ++i) {
+    buffer |= static_cast<uint64_t>(max_seat - seats[i]) << buffered;
+    buffered += bits;
+    while (buffered >= 8) {
+      *row++ = static_cast<char>(buffer & 0xff);
+      buffer >>= 8;
+      buffered -= 8;
+    }
+  }
+  if (buffered > 0) {
+    *row = static_cast<char>(buffer);
+  }
+}
+
+static int DayOffset(Date start_sale, Date date) {
+  return (Time(date, {0, 0}) - Time(start_sale, {0, 0})) / 1440;
+}
+
+RID TicketSystem::ReserveSeats(int days, int station_num, int32_t max_seat) {
+  auto row_size = RowSize(station_num, max_seat);
+  if (tail_page_id_ != INVALID_PAGE_ID && days * row_size <= static_cast<int>(BUSTUB_PAGE_SIZE) - tail_used_) {
+    RID matrix{tail_page_id_, tail_used_};
+    tail_used_ += days * row_size;
+    return matrix;
+  }
+  auto rows_per_page = static_cast<int>(BUSTUB_PAGE_SIZE) / row_size;
+  auto page_num = (days + rows_per_page - 1) / rows_per_page;
+  RID matrix{INVALID_PAGE_ID, 0};
+  for (int i = 0; i < page_num; ++i) {
+    page_id_t page_id;
+    // Extend the file rather than reuse deleted pages, so that the pages of the matrix are consecutive. Mark the
+    // zeroed page dirty, so that it is written out before it is read back.
+    bpm_->NewPageGuarded(&page_id, false).GetDataMut();
+    if (i == 0) {
+      matrix.page_id_ = page_id;
+    }
+    // LocateRow would hand out the rows of another matrix.
+    if (page_id != matrix.page_id_ + i) {
+      throw std::exception();
+    }
+  }
+  tail_page_id_ = matrix.page_id_ + page_num - 1;
+  tail_used_ = (days - (page_num - 1) * rows_per_page) * row_size;
+  return matrix;
 }
 
-void TicketSystem::FetchTicket(Date date, int32_t seat_num, DetailedTrainInfo& info) const {
-  vector<RID> rid;
-  index_->GetValue({StringHash(info.train_id_), date}, &rid);
-  if (rid.empty()) {
+SeatCacheEntry *TicketSystem::FetchRow(const RID &row, int station_num, int32_t max_seat) {
+  auto entry = cache_.Find(row);
+  if (entry == nullptr) {
+    entry = cache_.Insert(row, static_cast<int8_t>(station_num), max_seat);
+    {
+      auto cur_guard = bpm_->FetchPageRead(row.page_id_);
+      UnpackRow(cur_guard.GetData() + row.pos_, station_num, max_seat, entry->seats_);
+    }
+    Evict();
+  }
+  return entry;
+}
+
+void TicketSystem::Evict() {
+  while (auto entry = cache_.EvictOverBudget()) {
+    if (entry->dirty_) {
+      WriteBack(entry);
+    }
+    cache_.Release(entry);
+  }
+}
+
+void TicketSystem::WriteBack(const SeatCacheEntry *entry) {
+  auto cur_guard = bpm_->FetchPageWrite(entry->row_.page_id_);
+  PackRow(cur_guard.GetDataMut() + entry->row_.pos_, entry->station_num_, entry->max_seat_, entry->seats_);
+}
+
+void TicketSystem::FetchTicket(Date date, DetailedTrainInfo& info) {
+  if (info.seats_.page_id_ == INVALID_PAGE_ID) {
     for (int i = 0; i < info.station_num_ - 1; ++i) {
-      info.seat_num_[i] = seat_num;
+      info.seat_num_[i] = info.max_seat_;
     }
-  } else {
-    auto cur_guard = bpm_->FetchPageRead(rid[0].page_id_);
-    auto cur_page = cur_guard.As<DynamicTuplePage>();
-    cur_page->As(rid[0].pos_, info.seat_num_, info.station_num_);
+    return;
   }
+  auto row = LocateRow(info.seats_, RowSize(info.station_num_, info.max_seat_), DayOffset(info.start_sale_, date));
+  auto entry = FetchRow(row, info.station_num_, info.max_seat_);
+  std::copy(entry->seats_, entry->seats_ + info.station_num_ - 1, info.seat_num_);
+}
+
+void TicketSystem::FetchSeats(const TrainStop &stop, Date date, int32_t *seats) {
+  auto row = LocateRow(stop.seats_, RowSize(stop.station_num_, stop.seat_num_), DayOffset(stop.start_sale_, date));
+  auto entry = FetchRow(row, stop.station_num_, stop.seat_num_);
+  std::copy(entry->seats_, entry->seats_ + stop.station_num_ - 1, seats);
 }
 
 void TicketSystem::ModifyTicket(Date date, const DetailedTrainInfo& info) {
-  vector<RID> rid;
-  index_->GetValue({StringHash(info.train_id_), date}, &rid);
-  if (rid.empty()) {
-    if (dynamic_page_id_ == INVALID_PAGE_ID) {
-      auto new_guard = bpm_->NewPageGuarded(&dynamic_page_id_);
-      auto cur_page = new_guard.AsMut<DynamicTuplePage>();
-      auto new_rid = cur_page->Append(info.seat_num_, info.station_num_);
-      index_->Insert(pair(StringHash(info.train_id_), date), {dynamic_page_id_, new_rid});
-      return;
-    }
-    auto cur_guard = bpm_->FetchPageWrite(dynamic_page_id_);
-    auto cur_page = cur_guard.AsMut<DynamicTuplePage>();
-    if (cur_page->IsFull(info.seat_num_, info.station_num_)) {
-      auto new_guard = bpm_->NewPageGuarded(&dynamic_page_id_);
-      cur_page = new_guard.AsMut<DynamicTuplePage>();
-    }
-    auto new_rid = cur_page->Append(info.seat_num_, info.station_num_);
-    index_->Insert(pair(StringHash(info.train_id_), date), {dynamic_page_id_, new_rid});
-  } else {
-    auto cur_guard = bpm_->FetchPageWrite(rid[0].page_id_);
-    auto cur_page = cur_guard.AsMut<DynamicTuplePage>();
-    cur_page->Modify(rid[0].pos_, info.seat_num_, info.station_num_);
+  auto row = LocateRow(info.seats_, RowSize(info.station_num_, info.max_seat_), DayOffset(info.start_sale_, date));
+  auto entry = cache_.Find(row);
+  if (entry == nullptr) {
+    // The new counts replace the whole row, so it need not be read.
+    entry = cache_.Insert(row, static_cast<int8_t>(info.station_num_), info.max_seat_);
   }
+  std::copy(info.seat_num_, info.seat_num_ + info.station_num_ - 1, entry->seats_);
+  entry->dirty_ = true;
+  Evict();
 }
@@ -1,6 +1,11 @@
+#include <cassert>
+#include <sstream>
+
 #include <ticket/train_system.h>
 
 #include "common/utils.h"
+#include "ticket/seat_kernel.h"
+#include "ticket/transfer_planner.h"
 
 using std::cout, std::endl;
 
@@ -10,66 +15,53 @@ TrainSystem::TrainSystem(shared_ptr<BufferPoolManager> bpm,
                          shared_ptr<BufferPoolManager> waitlist_bpm,
                          shared_ptr<BufferPoolManager> orderlist_bpm)
 : bpm_(std::move(bpm)), station_bpm_(std::move(station_bpm)),
-  index_(new BPlusTree<unsigned long long, RID, std::less<>>(bpm_, {})),
-  station_index_(new BPlusTree<pair<unsigned long long, RID>, RID, std::less<>>(station_bpm_, {})),
+  index_(new ExtendibleHashTable<unsigned long long, RID>(bpm_, TRAIN_BLOOM_CAPACITY)),
+  free_space_map_(new FreeSpaceMap(bpm_.get())),
+  station_index_(new BPlusTree<unsigned long long, PostingList<TrainStop>, std::less<>>(station_bpm_, {})),
+  station_dictionary_(new StationDictionary(station_bpm_)),
   ticket_system_(new TicketSystem(std::move(ticket_bpm))),
   waitlist_(new WaitList(std::move(waitlist_bpm))),
-  orderlist_(new OrderList(std::move(orderlist_bpm))) {
-  auto cur_guard = bpm_->FetchPageRead(0);
-  auto cur_page = cur_guard.As<BPlusTreeHeaderPage>();
-  tuple_page_id_ = cur_page->tuple_page_id_;
-  dynamic_page_id_ = cur_page->dynamic_page_id_;
-}
+  orderlist_(new OrderList(std::move(orderlist_bpm))),
+  query_cache_(new QueryCache(QUERY_CACHE_CAPACITY)) {}
+
+TrainSystem::~TrainSystem() = default;
 
-TrainSystem::~TrainSystem() {
-  auto cur_guard = bpm_->FetchPageWrite(0);
-  auto cur_page = cur_guard.AsMut<BPlusTreeHeaderPage>();
-  cur_page->tuple_page_id_ = tuple_page_id_;
-  cur_page->dynamic_page_id_ = dynamic_page_id_;
+// Size of a train record.
+static constexpr std::size_t TrainRecordSize(int station_num) {
+  return sizeof(TrainInfo) + station_num * 4 * sizeof(int32_t);
 }
 
-bool TrainSystem::FetchTrainInfo(const string& train_id, TrainInfo& info) const {
-  vector<RID> train_rid;
-  index_->GetValue(StringHash(train_id), &train_rid);
-  if (train_rid.empty()) {
-    return false;
-  }
-  auto cur_guard = bpm_->FetchPageRead(train_rid[0].page_id_);
-  auto cur_page = cur_guard.As<TuplePage<TrainInfo>>();
-  info = cur_page->At(train_rid[0].pos_);
-  return true;
+static_assert(TrainRecordSize(STATION_MAX_NUM) <= DYNAMIC_TUPLE_MAX_RECORD_SIZE);
+
+RID TrainSystem::WriteDynamicInfo(const string& data) {
+  auto cur_guard = FetchDynamicPage(data.size());
+  auto cur_page = cur_guard.AsMut<DynamicTuplePage>();
+  auto pos = cur_page->Insert(data);
+  free_space_map_->Update(cur_guard.PageId(), cur_page->FreeSpace());
+  return {cur_guard.PageId(), pos};
 }
 
-void TrainSystem::FetchDynamicInfo(const RID& rid, string& ret) const {
-  auto cur_guard = bpm_->FetchPageRead(rid.page_id_);
-  auto cur_page = cur_guard.As<DynamicTuplePage>();
-  ret = cur_page->At(rid.pos_);
+void TrainSystem::DeleteDynamicInfo(const RID& rid) {
+  auto cur_guard = bpm_->FetchPageWrite(rid.page_id_);
+  auto cur_page = cur_guard.AsMut<DynamicTuplePage>();
+  cur_page->Delete(rid.pos_);
+  free_space_map_->Update(rid.page_id_, cur_page->FreeSpace());
 }
 
-RID TrainSystem::WriteDynamicInfo(const string& data) {
-  DynamicTuplePage *cur_page;
-  if (dynamic_page_id_ == INVALID_PAGE_ID) {
-    auto cur_guard = bpm_->NewPageGuarded(&dynamic_page_id_);
-    cur_page = cur_guard.AsMut<DynamicTuplePage>();
-  } else {
-    auto cur_guard = bpm_->FetchPageWrite(dynamic_page_id_);
-    cur_page = cur_guard.AsMut<DynamicTuplePage>();
-    if (cur_page->IsFull(data)) {
-      auto new_guard = bpm_->NewPageGuarded(&dynamic_page_id_);
-      cur_page = new_guard.AsMut<DynamicTuplePage>();
-    }
+WritePageGuard TrainSystem::FetchDynamicPage(std::size_t size) {
+  auto page_id = free_space_map_->Find(size);
+  if (page_id == INVALID_PAGE_ID) {
+    auto new_guard = bpm_->NewPageGuarded(&page_id);
+    new_guard.AsMut<DynamicTuplePage>()->Init();
   }
-  auto pos = cur_page->Append(data);
-  return {dynamic_page_id_, pos};
+  return bpm_->FetchPageWrite(page_id);
 }
 
-
 void TrainSystem::AddTrain(const string para[26]) {
   const string &train_id = para['i' - 'a'];
   const auto station_num = static_cast<int8_t>(std::stoi(para['n' - 'a']));
   int32_t seat_num = std::stoi(para['m' - 'a']);
   const string &station = para['s' - 'a'];
-  auto stations = SplitString(para['s' - 'a']);
   auto prices = SplitAndConvert<int32_t>(para['p' - 'a'], station_num, 0);
   Moment start_time(para['x' - 'a']);
   auto travel_time = SplitAndConvert<int16_t>(para['t' - 'a'], station_num, 0);
@@ -80,41 +72,48 @@ void TrainSystem::AddTrain(const string para[26]) {
   auto end_sale = Date(sales_date[1]);
   const char type = para['y' - 'a'][0];
 
-  TrainInfo data{};
-  if (FetchTrainInfo(train_id, data)) {
+  auto train_slot = index_->GetOrInsert(StringHash(train_id), RID{});
+  if (!train_slot.inserted_) {
     delete [] prices;
     delete [] travel_time;
     delete [] stopover_time;
     Fail();
     return;
   }
+  TrainInfo data{};
   train_id.copy(data.train_id_, string::npos);
   data.start_sale_ = start_sale;
   data.end_sale_ = end_sale;
   data.start_time_ = start_time;
   data.station_num_ = station_num;
   data.type_ = type;
-  data.stations_ = WriteDynamicInfo(station);
   data.seat_num_ = seat_num;
-  data.prices_ = WriteDynamicInfo(prices, station_num);
-  data.travel_time_ = WriteDynamicInfo(travel_time, station_num);
-  data.stopover_time_ = WriteDynamicInfo(stopover_time, station_num);
-
-  TuplePage<TrainInfo> *cur_page;
-  if (tuple_page_id_ == INVALID_PAGE_ID) {
-    auto cur_guard = bpm_->NewPageGuarded(&tuple_page_id_);
-    cur_page = cur_guard.AsMut<TuplePage<TrainInfo>>();
-  } else {
-    auto cur_guard = bpm_->FetchPageWrite(tuple_page_id_);
-    cur_page = cur_guard.AsMut<TuplePage<TrainInfo>>();
-    if (cur_page->Full()) {
-      auto new_guard = bpm_->NewPageGuarded(&tuple_page_id_);
-      cur_page = new_guard.AsMut<TuplePage<TrainInfo>>();
-    }
-  }
-  RID train_rid{tuple_page_id_, cur_page->Append(data)};
 
-  index_->Insert(StringHash(train_id), train_rid);
+  int32_t price_sum[STATION_MAX_NUM]{}, arrive[STATION_MAX_NUM]{}, leave[STATION_MAX_NUM]{};
+  int32_t station_ids[STATION_MAX_NUM]{};
+  std::size_t begin = 0;
+  for (int i = 0; i < station_num; ++i) {
+    auto end = std::min(station.find('|', begin), station.size());
+    station_ids[i] = station_dictionary_->Intern(std::string_view(station).substr(begin, end - begin));
+    begin = end + 1;
+  }
+  for (int i = 1; i < station_num; ++i) {
+    price_sum[i] = price_sum[i - 1] + prices[i - 1];
+    arrive[i] = leave[i - 1] + travel_time[i - 1];
+    leave[i] = arrive[i] + (i == station_num - 1 ? 0 : stopover_time[i]);
+  }
+  string record(TrainRecordSize(station_num), '\0');
+  auto pos = record.data();
+  memcpy(pos, &data, sizeof(TrainInfo));
+  pos += sizeof(TrainInfo);
+  memcpy(pos, price_sum, sizeof(int32_t) * station_num);
+  pos += sizeof(int32_t) * station_num;
+  memcpy(pos, arrive, sizeof(int32_t) * station_num);
+  pos += sizeof(int32_t) * station_num;
+  memcpy(pos, leave, sizeof(int32_t) * station_num);
+  pos += sizeof(int32_t) * station_num;
+  memcpy(pos, station_ids, sizeof(int32_t) * station_num);
+  *train_slot.value_ = WriteDynamicInfo(record);
   Succeed();
   delete [] prices;
   delete [] travel_time;
@@ -123,14 +122,18 @@ void TrainSystem::AddTrain(const string para[26]) {
 
 void TrainSystem::DeleteTrain(const string para[26]) {
   const string &train_id = para['i' - 'a'];
-  vector<RID> train_rid;
-  if (index_->GetValue(StringHash(train_id), &train_rid)) {
-    auto cur_guard = bpm_->FetchPageRead(train_rid[0].page_id_);
-    auto cur_page = cur_guard.As<TuplePage<TrainInfo>>();
-    if (cur_page->At(train_rid[0].pos_).released_ == true) {
+  auto train_rid = index_->Find(StringHash(train_id));
+  if (train_rid.has_value()) {
+    TrainInfo info;
+    {
+      auto cur_guard = bpm_->FetchPageRead(train_rid->page_id_);
+      cur_guard.As<DynamicTuplePage>()->As(train_rid->pos_, &info, 1);
+    }
+    if (info.released_ == true) {
       Fail();
     } else {
       index_->Remove(StringHash(train_id));
+      DeleteDynamicInfo(*train_rid);
       Succeed();
     }
   } else {
@@ -141,55 +144,68 @@ void TrainSystem::DeleteTrain(const string para[26]) {
 void TrainSystem::ReleaseTrain(const string para[26]) {
   const string &train_id = para['i' - 'a'];
   TrainInfo info{};
-  vector<RID> train_rid;
-  index_->GetValue(StringHash(train_id), &train_rid);
-  if (train_rid.empty()) {
+  auto train_rid = index_->Find(StringHash(train_id));
+  if (!train_rid.has_value()) {
     Fail();
     return;
   }
-  auto cur_guard = bpm_->FetchPageWrite(train_rid[0].page_id_);
-  auto cur_page = cur_guard.AsMut<TuplePage<TrainInfo>>();
-  info = cur_page->At(train_rid[0].pos_);
+  auto cur_guard = bpm_->FetchPageWrite(train_rid->page_id_);
+  auto cur_page = cur_guard.AsMut<DynamicTuplePage>();
+  cur_page->As(train_rid->pos_, &info, 1);
   if (info.released_ == true) {
     Fail();
     return;
   }
-  cur_page->operator[](train_rid[0].pos_).released_ = true;
-  string station;
-  FetchDynamicInfo(info.stations_, station);
-  for (const auto &i : SplitString(station)) {
-    station_index_->Insert({StringHash(i), train_rid[0]}, train_rid[0]);
+  info.released_ = true;
+  info.seats_ = ticket_system_->ReserveSeats(
+    (Time(info.end_sale_, {0, 0}) - Time(info.start_sale_, {0, 0})) / 1440 + 1, info.station_num_, info.seat_num_);
+  cur_page->Modify(train_rid->pos_, &info, 1);
+  cur_guard.Drop();
+  DetailedTrainInfo detailed_info{};
+  FetchDetailedTrainInfo(*train_rid, detailed_info);
+  TrainStop stop{};
+  stop.rid_ = *train_rid;
+  stop.seat_num_ = info.seat_num_;
+  memcpy(stop.train_id_, info.train_id_, sizeof(stop.train_id_));
+  stop.start_sale_ = info.start_sale_;
+  stop.end_sale_ = info.end_sale_;
+  stop.start_time_ = info.start_time_;
+  stop.station_num_ = info.station_num_;
+  stop.seats_ = info.seats_;
+  for (int i = 0; i < info.station_num_; ++i) {
+    stop.price_sum_ = detailed_info.price_sum_[i];
+    stop.arrive_ = detailed_info.arrive_[i];
+    stop.leave_ = detailed_info.leave_[i];
+    stop.pos_ = static_cast<int8_t>(i);
+    station_index_->InsertEntry(detailed_info.stations_[i], stop);
   }
+  query_cache_->InvalidateStations(detailed_info.stations_, info.station_num_);
   Succeed();
 }
 
 void TrainSystem::QueryTrain(const string para[26]) {
   const string &train_id = para['i' - 'a'];
   Date date(para['d' - 'a']);
-  TrainInfo info;
-  if (!FetchTrainInfo(train_id, info)) {
+  DetailedTrainInfo detailed_info{};
+  if (!FetchDetailedTrainInfo(train_id, detailed_info)) {
     Fail();
     return;
   }
-
-  DetailedTrainInfo detailed_info{};
-  FetchDetailedTrainInfo(info, date, detailed_info);
-  if (date < info.start_sale_ || date > info.end_sale_) {
+  if (date < detailed_info.start_sale_ || date > detailed_info.end_sale_) {
     Fail();
     return;
   }
+  ticket_system_->FetchTicket(date, detailed_info);
 
   auto n = detailed_info.station_num_;
-  cout << train_id << " " << info.type_ << endl;
-  int total_price = 0;
-  Time cur_time(date, info.start_time_);
+  cout << train_id << " " << detailed_info.type_ << endl;
+  Time start_time(date, detailed_info.start_time_);
   for (int i = 0; i < n; ++i) {
-    cout << detailed_info.stations_[i] << " "
-         << (i == 0 ? "xx-xx xx:xx" : cur_time.ToString()) << " -> "
-         << (i == n - 1 ? "xx-xx xx:xx" : (cur_time += detailed_info.stopover_time_[i]).ToString()) << " "
-         << total_price << " " << (i == n - 1 ? "x" : std::to_string(detailed_info.seat_num_[i])) << endl;
-    total_price += detailed_info.prices_[i];
-    cur_time += detailed_info.travel_time_[i];
+    cout << station_dictionary_->Name(detailed_info.stations_[i]) << " "
+         << (i == 0 ? "xx-xx xx:xx" : (start_time + detailed_info.arrive_[i]).ToString()) << " -> "
+         << (i == n - 1 ? "xx-xx xx:xx" : (start_time + detailed_info.leave_[i]).ToString()) << " "
+         << detailed_info.price_sum_[i] << " "
+         << (i == n - 1 ? "x" : std::to_string(detailed_info.seat_num_[i])) << endl;
   }
 }
 
@@ -209,20 +225,8 @@ bool OrderByPrice(const TicketInfo &lhs, const TicketInfo &rhs) {
   return lhs.price_ != rhs.price_ ? lhs.price_ <= rhs.price_ : lhs.train_id_ <= rhs.train_id_;
 }
 
-void TrainSystem::FetchTrainInfoStation(const string& station_name, vector<RID>& ret) {
-  auto station_hash = StringHash(station_name);
-  auto it = station_index_->LowerBound({station_hash, RID_MIN});
-  if (!it) {
-    return;
-  }
-  while ((*it).first.first == station_hash) {
-    ret.push_back((*it).second);
-    if (it.IsEnd()) {
-      break;
-    }
-    ++it;
-  }
-  ret.sort();
+void TrainSystem::FetchTrainInfoStation(int32_t station_id, vector<TrainStop>& ret) {
+  station_index_->GetAll(station_id, &ret);
 }
 
 
@@ -231,134 +235,87 @@ void TrainSystem::QueryTicket(const string para[26]) {
   const string &end = para['t' - 'a'];
   bool order_by_cost = (para['p' - 'a'] == "cost");
   Date date(para['d' - 'a']);
+  auto start_id = station_dictionary_->Find(start);
+  auto end_id = station_dictionary_->Find(end);
+  QueryKey key{start_id, end_id, date, order_by_cost};
+  if (auto output = query_cache_->Find(key)) {
+    cout << *output << std::flush;
+    return;
+  }
 
-  vector<RID> train_rid1;
-  vector<RID> train_rid2;
-  FetchTrainInfoStation(start, train_rid1);
-  FetchTrainInfoStation(end, train_rid2);
-
+  vector<TrainStop> end_stops;
+  FetchTrainInfoStation(end_id, end_stops);
   vector<TicketInfo> result;
-  int pos = 0;
-  for (const auto &i : train_rid1) {
-    while (pos < train_rid2.size() && train_rid2[pos] < i) {
-      ++pos;
-    }
-    if (pos == train_rid2.size()) {
-      break;
-    }
-    if (train_rid2[pos] != i) {
-      continue;
-    }
-    auto cur_guard = bpm_->FetchPageRead(i.page_id_);
-    auto cur_page = cur_guard.As<TuplePage<TrainInfo>>();
-    auto train_info = cur_page->At(i.pos_);
-    DetailedTrainInfo detailed_info{};
-    FetchDetailedTrainInfo(train_info, detailed_info);
-    auto n = train_info.station_num_;
-
-    int start_pos = -1, end_pos = -1;
-    for (int j = 0; j < n; ++j) {
-      if (detailed_info.stations_[j] == start) {
-        start_pos = j;
+  vector<SeatKey> seat_keys;
+  size_t pos = 0;
+  int32_t seats[STATION_MAX_NUM];
+  station_index_->ScanPrefix(start_id, [&](const TrainStop *stops, int count) {
+    for (int k = 0; k < count; ++k) {
+      while (pos < end_stops.size() && end_stops[pos] < stops[k]) {
+        ++pos;
       }
-      if (detailed_info.stations_[j] == end) {
-        end_pos = j;
+      if (pos == end_stops.size()) {
+        return false;
       }
-    }
-    if (start_pos > end_pos) {
-      continue;
-    }
-
-    int elapsed_time = 0;
-    for (int j = 0; j < start_pos; ++j) {
-      elapsed_time += detailed_info.travel_time_[j];
-    }
-    for (int j = 1; j <= start_pos; ++j) {
-      elapsed_time += detailed_info.stopover_time_[j];
-    }
-    if ((Time(train_info.start_sale_, train_info.start_time_) + elapsed_time).GetDate() > date ||
-        (Time(train_info.end_sale_, train_info.start_time_) + elapsed_time).GetDate() < date) {
-      continue;
-    }
-    TicketInfo cur_ticket{};
-    cur_ticket.train_id_ = train_info.train_id_;
-    cur_ticket.seat_ = 100000;
-    auto start_time = Time(date, {0, 0}) - elapsed_time;
-    if (start_time.GetMoment() > train_info.start_time_) {
-      start_time += 1440;
-      start_time.SetMoment(train_info.start_time_);
-      cur_ticket.leave_ = start_time + elapsed_time;
-    } else {
-      start_time.SetMoment(train_info.start_time_);
+      const auto &from = stops[k];
+      const auto &to = end_stops[pos];
+      if (!(from == to) || from.pos_ >= to.pos_) {
+        continue;
+      }
+      int elapsed_time = from.leave_;
+      if ((Time(from.start_sale_, from.start_time_) + elapsed_time).GetDate() > date ||
+          (Time(from.end_sale_, from.start_time_) + elapsed_time).GetDate() < date) {
+        continue;
+      }
+      TicketInfo cur_ticket{};
+      cur_ticket.train_id_ = from.train_id_;
+      auto start_time = Time(date, {0, 0}) - elapsed_time;
+      if (start_time.GetMoment() > from.start_time_) {
+        start_time += 1440;
+      }
+      start_time.SetMoment(from.start_time_);
       cur_ticket.leave_ = start_time + elapsed_time;
+      ticket_system_->FetchSeats(from, start_time.GetDate(), seats);
+      seat_keys.push_back({from.seats_, start_time.GetDate()});
+      cur_ticket.duration_ = to.arrive_ - elapsed_time;
+      cur_ticket.price_ = to.price_sum_ - from.price_sum_;
+      cur_ticket.seat_ = SeatRangeMin(seats, from.pos_, to.pos_);
+      result.push_back(cur_ticket);
     }
-    ticket_system_->FetchTicket(start_time.GetDate(), train_info.seat_num_, detailed_info);
-
-    for (int j = start_pos; j < end_pos; ++j) {
-      cur_ticket.duration_ += detailed_info.travel_time_[j];
-      cur_ticket.price_ += detailed_info.prices_[j];
-      cur_ticket.seat_ = std::min(cur_ticket.seat_, detailed_info.seat_num_[j]);
-    }
-    for (int j = start_pos + 1; j < end_pos; ++j) {
-      cur_ticket.duration_ += detailed_info.stopover_time_[j];
-    }
-    result.push_back(cur_ticket);
-  }
+    return true;
+  });
 
   if (order_by_cost) {
     result.sort(OrderByPrice);
   } else {
     result.sort(OrderByTime);
   }
-  cout << result.size() << endl;
+  std::ostringstream output;
+  output << result.size() << '\n';
   for (const auto &ticket_info : result) {
-    cout << ticket_info.train_id_ << " " << start << " " << ticket_info.leave_ << " -> "
-         << end << " " << (ticket_info.leave_ + ticket_info.duration_) << " "
-         << ticket_info.price_ << " " << ticket_info.seat_ << endl;
+    output << ticket_info.train_id_ << " " << start << " " << ticket_info.leave_ << " -> "
+           << end << " " << (ticket_info.leave_ + ticket_info.duration_) << " "
+           << ticket_info.price_ << " " << ticket_info.seat_ << '\n';
   }
+  auto text = output.str();
+  cout << text << std::flush;
+  query_cache_->Insert(key, text, seat_keys);
 }
 
-void TrainSystem::FetchDetailedTrainInfo(const RID& rid, DetailedTrainInfo& info) const {
-  auto cur_guard = bpm_->FetchPageRead(rid.page_id_);
-  auto cur_page = cur_guard.As<TuplePage<TrainInfo>>();
-  auto brief = cur_page->At(rid.pos_);
-  info.type_ = brief.type_;
-  info.train_id_ = brief.train_id_;
-  info.start_sale_ = brief.start_sale_;
-  info.end_sale_ = brief.end_sale_;
-  info.start_time_ = brief.start_time_;
-  info.station_num_ = brief.station_num_;
-  info.max_seat_ = brief.seat_num_;
-
-  auto n = info.station_num_;
-  FetchDynamicInfo(brief.prices_, info.prices_, n);
-  FetchDynamicInfo(brief.stopover_time_, info.stopover_time_, n);
-  FetchDynamicInfo(brief.travel_time_, info.travel_time_, n);
-  string station;
-  FetchDynamicInfo(brief.stations_, station);
-  info.stations_ = SplitString(station);
-}
-
-void TrainSystem::FetchDetailedTrainInfo(const TrainInfo& brief, Date date, DetailedTrainInfo& info) const {
-  info.type_ = brief.type_;
-  info.train_id_ = brief.train_id_;
-  info.start_sale_ = brief.start_sale_;
-  info.end_sale_ = brief.end_sale_;
-  info.start_time_ = brief.start_time_;
-  info.station_num_ = brief.station_num_;
-  info.max_seat_ = brief.seat_num_;
-
-  auto n = info.station_num_;
-  FetchDynamicInfo(brief.prices_, info.prices_, n);
-  FetchDynamicInfo(brief.stopover_time_, info.stopover_time_, n);
-  FetchDynamicInfo(brief.travel_time_, info.travel_time_, n);
-  string station;
-  FetchDynamicInfo(brief.stations_, station);
-  info.stations_ = SplitString(station);
-  ticket_system_->FetchTicket(date, brief.seat_num_, info);
+bool TrainSystem::FetchDetailedTrainInfo(const string& train_id, DetailedTrainInfo& info) const {
+  auto train_rid = index_->Find(StringHash(train_id));
+  if (!train_rid.has_value()) {
+    return false;
+  }
+  FetchDetailedTrainInfo(*train_rid, info);
+  return true;
 }
 
-void TrainSystem::FetchDetailedTrainInfo(const TrainInfo& brief, DetailedTrainInfo& info) const {
+void TrainSystem::FetchDetailedTrainInfo(const RID& rid, DetailedTrainInfo& info) const {
+  auto cur_guard = bpm_->FetchPageRead(rid.page_id_);
+  auto record = cur_guard.As<DynamicTuplePage>()->View(rid.pos_);
+  TrainInfo brief;
+  memcpy(&brief, record.data(), sizeof(TrainInfo));
   info.type_ = brief.type_;
   info.train_id_ = brief.train_id_;
   info.start_sale_ = brief.start_sale_;
@@ -366,14 +323,18 @@ void TrainSystem::FetchDetailedTrainInfo(const TrainInfo& brief, DetailedTrainIn
   info.start_time_ = brief.start_time_;
   info.station_num_ = brief.station_num_;
   info.max_seat_ = brief.seat_num_;
+  info.released_ = brief.released_;
+  info.seats_ = brief.seats_;
 
   auto n = info.station_num_;
-  FetchDynamicInfo(brief.prices_, info.prices_, n);
-  FetchDynamicInfo(brief.stopover_time_, info.stopover_time_, n);
-  FetchDynamicInfo(brief.travel_time_, info.travel_time_, n);
-  string station;
-  FetchDynamicInfo(brief.stations_, station);
-  info.stations_ = SplitString(station);
+  auto pos = record.data() + sizeof(TrainInfo);
+  memcpy(info.price_sum_, pos, sizeof(int32_t) * n);
+  pos += sizeof(int32_t) * n;
+  memcpy(info.arrive_, pos, sizeof(int32_t) * n);
+  pos += sizeof(int32_t) * n;
+  memcpy(info.leave_, pos, sizeof(int32_t) * n);
+  pos += sizeof(int32_t) * n;
+  memcpy(info.stations_, pos, sizeof(int32_t) * n);
 }
 
 bool OrderByTime(const TicketInfo &lhs1, const TicketInfo &lhs2,
@@ -405,140 +366,127 @@ void TrainSystem::QueryTransfer(const string para[26]) {
   const string &end = para['t' - 'a'];
   Date date(para['d' - 'a']);
   bool order_by_cost = (para['p' - 'a'] == "cost");
-  vector<RID> rid1;
-  vector<RID> rid2;
-  FetchTrainInfoStation(start, rid1);
-  FetchTrainInfoStation(end, rid2);
+  auto start_id = station_dictionary_->Find(start);
+  auto end_id = station_dictionary_->Find(end);
+  ++transfer_stats_.queries_;
+  vector<TrainStop> stops1;
+  vector<TrainStop> stops2;
+  FetchTrainInfoStation(start_id, stops1);
+  FetchTrainInfoStation(end_id, stops2);
   vector<DetailedTrainInfo> train_info2;
-  for (const auto &rid : rid2) {
+  for (const auto &stop : stops2) {
     DetailedTrainInfo info{};
-    FetchDetailedTrainInfo(rid, info);
+    FetchDetailedTrainInfo(stop.rid_, info);
     train_info2.push_back(info);
   }
 
+  TransferPlanner planner;
+  planner.Build(train_info2, end_id);
+
+  // Total price and minutes of the best pair found so far. A candidate whose lower
+  // bound exceeds it can not win, so it is dropped before its seats are read.
   TicketInfo ticket1{}, ticket2{};
-  string transfer{};
-  for (auto &brief1 : rid1) {
+  int32_t transfer = -1;
+  auto best_price = [&]() { return ticket1.price_ + ticket2.price_; };
+  auto best_time = [&]() { return ticket2.leave_ - ticket1.leave_ + ticket2.duration_; };
+  auto exceeds_best = [&](int price, int duration) {
+    return !ticket1.train_id_.empty() &&
+           (order_by_cost ? price > best_price() : duration > best_time());
+  };
+  for (auto &brief1 : stops1) {
+    if (exceeds_best(planner.MinPrice(), planner.MinDuration())) {
+      continue;
+    }
+    int start_pos = brief1.pos_;
+    int elapsed_time1 = brief1.leave_;
+    if ((Time(brief1.start_sale_, brief1.start_time_) + elapsed_time1).GetDate() > date ||
+        (Time(brief1.end_sale_, brief1.start_time_) + elapsed_time1).GetDate() < date) {
+      continue;
+    }
+    Time start_time1 = Time(date, {0, 0}) - elapsed_time1;
+    if (start_time1.GetMoment() <= brief1.start_time_) {
+      start_time1.SetMoment(brief1.start_time_);
+    } else {
+      start_time1 += 1440;
+      start_time1.SetMoment(brief1.start_time_);
+    }
     DetailedTrainInfo train1{};
-    FetchDetailedTrainInfo(brief1, train1);
-    int start_pos = -1;
-    for (int i = 0; i < train1.station_num_; ++i) {
-      if (train1.stations_[i] == start) {
-        start_pos = i;
+    FetchDetailedTrainInfo(brief1.rid_, train1);
+    bool seat_fetched = false;
+    for (int transfer_pos1 = start_pos + 1; transfer_pos1 < train1.station_num_; ++transfer_pos1) {
+      // The price and duration of the first leg only grow with the transfer station.
+      if (exceeds_best(train1.price_sum_[transfer_pos1] - train1.price_sum_[start_pos] + planner.MinPrice(),
+                       train1.arrive_[transfer_pos1] - elapsed_time1 + planner.MinDuration())) {
         break;
       }
-    }
-    for (auto &train2 : train_info2) {
-      if (train1.train_id_ == train2.train_id_) {
-        continue;
-      }
-      int end_pos = -1;
-      for (int i = 0; i < train2.station_num_; ++i) {
-        if (train2.stations_[i] == end) {
-          end_pos = i;
-          break;
+      planner.Probe(train1.stations_[transfer_pos1], [&](const TransferPlanner::Leg &leg) {
+        auto &train2 = train_info2[leg.train_];
+        if (train1.train_id_ == train2.train_id_) {
+          return;
         }
-      }
-      int transfer_pos1, transfer_pos2;
-      for (int i = start_pos + 1; i < train1.station_num_; ++i) {
-        for (int j = 0; j < end_pos; ++j) {
-          if (train1.stations_[i] != train2.stations_[j]) {
-            continue;
-          }
-          transfer_pos1 = i;
-          transfer_pos2 = j;
-          int elapsed_time1 = 0;
-          int elapsed_time2 = 0;
-          int duration1 = 0;
-          int duration2 = 0;
-          int price1 = 0;
-          int price2 = 0;
-          int max_seat1 = 100000;
-          int max_seat2 = 100000;
-          for (int k = 0; k < start_pos; ++k) {
-            elapsed_time1 += train1.travel_time_[k];
-          }
-          for (int k = 1; k <= start_pos; ++k) {
-            elapsed_time1 += train1.stopover_time_[k];
-          }
-          for (int k = 0; k < transfer_pos2; ++k) {
-            elapsed_time2 += train2.travel_time_[k];
-          }
-          for (int k = 1; k <= transfer_pos2; ++k) {
-            elapsed_time2 += train2.stopover_time_[k];
-          }
-          if ((Time(train1.start_sale_, train1.start_time_) + elapsed_time1).GetDate() > date ||
-              (Time(train1.end_sale_, train1.start_time_) + elapsed_time1).GetDate() < date) {
-            continue;
-          }
-          Time start_time1 = Time(date, {0, 0}) - elapsed_time1;
-          if (start_time1.GetMoment() <= train1.start_time_) {
-            start_time1.SetMoment(train1.start_time_);
-          } else {
-            start_time1 += 1440;
-            start_time1.SetMoment(train1.start_time_);
-          }
-          ticket_system_->FetchTicket(start_time1.GetDate(), train1.max_seat_, train1);
-          for (int k = start_pos; k < transfer_pos1; ++k) {
-            duration1 += train1.travel_time_[k];
-            price1 += train1.prices_[k];
-            max_seat1 = std::min(max_seat1, train1.seat_num_[k]);
-          }
-          for (int k = start_pos + 1; k < transfer_pos1; ++k) {
-            duration1 += train1.stopover_time_[k];
-          }
-          Time arrive_time_1 = start_time1 + elapsed_time1 + duration1;
-          if (Time(train2.end_sale_, train2.start_time_) + elapsed_time2 < arrive_time_1) {
-            continue;
-          }
-          Time start_time2{};
-          if (arrive_time_1 - elapsed_time2 < Time(train2.start_sale_, train2.start_time_)) {
-            start_time2 = Time(train2.start_sale_, train2.start_time_);
+        int transfer_pos2 = leg.transfer_pos_;
+        int end_pos = leg.end_pos_;
+        int elapsed_time2 = train2.leave_[transfer_pos2];
+        int duration1 = train1.arrive_[transfer_pos1] - elapsed_time1;
+        int duration2 = leg.duration_;
+        int price1 = train1.price_sum_[transfer_pos1] - train1.price_sum_[start_pos];
+        int price2 = leg.price_;
+        if (exceeds_best(price1 + price2, duration1 + duration2)) {
+          return;
+        }
+        Time arrive_time_1 = start_time1 + elapsed_time1 + duration1;
+        if (Time(train2.end_sale_, train2.start_time_) + elapsed_time2 < arrive_time_1) {
+          return;
+        }
+        Time start_time2{};
+        if (arrive_time_1 - elapsed_time2 < Time(train2.start_sale_, train2.start_time_)) {
+          start_time2 = Time(train2.start_sale_, train2.start_time_);
+        } else {
+          start_time2 = arrive_time_1 - elapsed_time2;
+          if (start_time2.GetMoment() <= train2.start_time_) {
+            start_time2.SetMoment(train2.start_time_);
           } else {
-            start_time2 = arrive_time_1 - elapsed_time2;
-            if (start_time2.GetMoment() <= train2.start_time_) {
-              start_time2.SetMoment(train2.start_time_);
-            } else {
-              start_time2 += 1440;
-              start_time2.SetMoment(train2.start_time_);
-            }
-          }
-          ticket_system_->FetchTicket(start_time2.GetDate(), train2.max_seat_, train2);
-          for (int k = transfer_pos2; k < end_pos; ++k) {
-            duration2 += train2.travel_time_[k];
-            price2 += train2.prices_[k];
-            max_seat2 = std::min(max_seat2, train2.seat_num_[k]);
-          }
-          for (int k = transfer_pos2 + 1; k < end_pos; ++k) {
-            duration2 += train2.stopover_time_[k];
+            start_time2 += 1440;
+            start_time2.SetMoment(train2.start_time_);
           }
+        }
 
-          TicketInfo cur_ticket1{train1.train_id_, start_time1 + elapsed_time1,
-                                 duration1, price1, max_seat1};
-          TicketInfo cur_ticket2{train2.train_id_, start_time2 + elapsed_time2,
-                                 duration2, price2, max_seat2};
-          if (order_by_cost && !ticket1.train_id_.empty() &&
-              OrderByPrice(ticket1, ticket2, cur_ticket1, cur_ticket2)) {
-            continue;
-          }
-          if (!order_by_cost && !ticket1.train_id_.empty() &&
-              OrderByTime(ticket1, ticket2, cur_ticket1, cur_ticket2)) {
-            continue;
+        // The order does not depend on the seats, so they are read only for a new best pair.
+        TicketInfo cur_ticket1{train1.train_id_, start_time1 + elapsed_time1, duration1, price1};
+        TicketInfo cur_ticket2{train2.train_id_, start_time2 + elapsed_time2, duration2, price2};
+        auto read_seats = [&]() {
+          if (!seat_fetched) {
+            ticket_system_->FetchTicket(start_time1.GetDate(), train1);
+            seat_fetched = true;
+            ++transfer_stats_.seat_reads_;
           }
-          ticket1 = cur_ticket1;
-          ticket2 = cur_ticket2;
-          transfer = train1.stations_[transfer_pos1];
+          cur_ticket1.seat_ = SeatRangeMin(train1.seat_num_, start_pos, transfer_pos1);
+          ticket_system_->FetchTicket(start_time2.GetDate(), train2);
+          ++transfer_stats_.seat_reads_;
+          cur_ticket2.seat_ = SeatRangeMin(train2.seat_num_, transfer_pos2, end_pos);
+        };
+        if (order_by_cost && !ticket1.train_id_.empty() &&
+            OrderByPrice(ticket1, ticket2, cur_ticket1, cur_ticket2)) {
+          return;
         }
-      }
+        if (!order_by_cost && !ticket1.train_id_.empty() &&
+            OrderByTime(ticket1, ticket2, cur_ticket1, cur_ticket2)) {
+          return;
+        }
+        read_seats();
+        ticket1 = cur_ticket1;
+        ticket2 = cur_ticket2;
+        transfer = train1.stations_[transfer_pos1];
+      });
     }
   }
   if (ticket1.train_id_.empty()) {
     cout << 0 << endl;
   } else {
     cout << ticket1.train_id_ << " " << start << " " << ticket1.leave_ << " -> "
-         << transfer << " " << ticket1.leave_ + ticket1.duration_ << " "
+         << station_dictionary_->Name(transfer) << " " << ticket1.leave_ + ticket1.duration_ << " "
          << ticket1.price_ << " " << ticket1.seat_ << endl;
-    cout << ticket2.train_id_ << " " << transfer << " " << ticket2.leave_ << " -> "
+    cout << ticket2.train_id_ << " " << station_dictionary_->Name(transfer) << " " << ticket2.leave_ << " -> "
          << end << " " << ticket2.leave_ + ticket2.duration_ << " "
          << ticket2.price_ << " " << ticket2.seat_ << endl;
   }
@@ -557,20 +505,18 @@ void TrainSystem::BuyTicket(const string para[26], const shared_ptr<UserSystem>
     Fail();
     return;
   }
-  TrainInfo brief{};
-  FetchTrainInfo(train_id, brief);
-  if (brief.released_ == false) {
+  DetailedTrainInfo info{};
+  if (!FetchDetailedTrainInfo(train_id, info) || info.released_ == false) {
     Fail();
     return;
   }
-  DetailedTrainInfo info{};
-  FetchDetailedTrainInfo(brief, info);
-  int elapsed_time = 0;
+  auto start_id = station_dictionary_->Find(start);
+  auto end_id = station_dictionary_->Find(end);
   int start_pos = -1, end_pos = -1;
   for (int i = 0; i < info.station_num_; ++i) {
-    if (info.stations_[i] == start) {
+    if (info.stations_[i] == start_id) {
       start_pos = i;
-    } else if (info.stations_[i] == end) {
+    } else if (info.stations_[i] == end_id) {
       end_pos = i;
       break;
     }
@@ -579,12 +525,7 @@ void TrainSystem::BuyTicket(const string para[26], const shared_ptr<UserSystem>
     Fail();
     return;
   }
-  for (int i = 0; i < start_pos; ++i) {
-    elapsed_time += info.travel_time_[i];
-  }
-  for (int i = 0; i <= start_pos; ++i) {
-    elapsed_time += info.stopover_time_[i];
-  }
+  int elapsed_time = info.leave_[start_pos];
   Time start_time = Time(date, {0, 0}) - elapsed_time;
   if (start_time.GetMoment() <= info.start_time_) {
     start_time.SetMoment(info.start_time_);
@@ -596,35 +537,26 @@ void TrainSystem::BuyTicket(const string para[26], const shared_ptr<UserSystem>
     Fail();
     return;
   }
-  ticket_system_->FetchTicket(start_time.GetDate(), brief.seat_num_, info);
-  if (num > brief.seat_num_) {
+  ticket_system_->FetchTicket(start_time.GetDate(), info);
+  if (num > info.max_seat_) {
     Fail();
     return;
   }
-  int price = 0;
-  int max_seat = 100000;
-  int duration = 0;
-  for (int i = start_pos; i < end_pos; ++i) {
-    price += info.prices_[i];
-    max_seat = std::min(max_seat, info.seat_num_[i]);
-    duration += info.travel_time_[i];
-  }
-  for (int i = start_pos + 1; i < end_pos; ++i) {
-    duration += info.stopover_time_[i];
-  }
+  int price = info.price_sum_[end_pos] - info.price_sum_[start_pos];
+  int duration = info.arrive_[end_pos] - elapsed_time;
+  int max_seat = SeatRangeMin(info.seat_num_, start_pos, end_pos);
   OrderInfo order{};
-  start.copy(order.from_, string::npos);
-  end.copy(order.to_, string::npos);
+  order.from_ = start_id;
+  order.to_ = end_id;
   train_id.copy(order.train_id_, string::npos);
   order.leave_ = start_time + elapsed_time;
   order.arrive_ = order.leave_ + duration;
   order.num_ = num;
   order.price_ = price;
   if (num <= max_seat) {
-    for (int i = start_pos; i < end_pos; ++i) {
-      info.seat_num_[i] -= num;
-    }
+    SeatRangeAdd(info.seat_num_, start_pos, end_pos, -num);
     ticket_system_->ModifyTicket(start_time.GetDate(), info);
+    query_cache_->InvalidateSeats({info.seats_, start_time.GetDate()});
     cout << 1ll * num * price << endl;
     order.status_ = OrderStatus::ksuccess;
     order.timestamp_ = waitlist_->GetTimeStamp();
@@ -645,7 +577,7 @@ void TrainSystem::QueryOrder(const string para[26], const shared_ptr<UserSystem>
     Fail();
     return;
   }
-  orderlist_->QueryOrder(username);
+  orderlist_->QueryOrder(username, *station_dictionary_);
 }
 
 void TrainSystem::RefundTicket(const string para[26], const shared_ptr<UserSystem> &user_system) {
@@ -662,11 +594,8 @@ void TrainSystem::RefundTicket(const string para[26], const shared_ptr<UserSyste
     return;
   }
 
-  TrainInfo brief{};
-  FetchTrainInfo({order.train_id_}, brief);
   DetailedTrainInfo info{};
-  FetchDetailedTrainInfo(brief, info);
-  int elapsed_time = 0;
+  FetchDetailedTrainInfo(order.train_id_, info);
   int start_pos = -1, end_pos = -1;
   for (int i = 0; i < info.station_num_; ++i) {
     if (info.stations_[i] == order.from_) {
@@ -676,12 +605,7 @@ void TrainSystem::RefundTicket(const string para[26], const shared_ptr<UserSyste
       break;
     }
   }
-  for (int i = 0; i < start_pos; ++i) {
-    elapsed_time += info.travel_time_[i];
-  }
-  for (int i = 0; i <= start_pos; ++i) {
-    elapsed_time += info.stopover_time_[i];
-  }
+  int elapsed_time = info.leave_[start_pos];
   Time start_time = order.leave_ - elapsed_time;
 
   auto it = waitlist_->FetchWaitlist(info.train_id_, start_time.GetDate());
@@ -697,10 +621,8 @@ void TrainSystem::RefundTicket(const string para[26], const shared_ptr<UserSyste
     Succeed();
     return;
   }
-  ticket_system_->FetchTicket(start_time.GetDate(), info.max_seat_, info);
-  for (int i = start_pos; i < end_pos; ++i) {
-    info.seat_num_[i] += order.num_;
-  }
+  ticket_system_->FetchTicket(start_time.GetDate(), info);
+  SeatRangeAdd(info.seat_num_, start_pos, end_pos, order.num_);
   while (it) {
     auto &wait_info = *it;
     if (!wait_info.queue) {
@@ -710,15 +632,9 @@ void TrainSystem::RefundTicket(const string para[26], const shared_ptr<UserSyste
       ++it;
       continue;
     }
-    int max_seat = 100000;
-    for (int i = wait_info.start_pos_; i < wait_info.end_pos_; ++i) {
-      max_seat = std::min(max_seat, info.seat_num_[i]);
-    }
-    if (max_seat >= wait_info.num_) {
+    if (SeatRangeMin(info.seat_num_, wait_info.start_pos_, wait_info.end_pos_) >= wait_info.num_) {
       orderlist_->QueueSucceed(wait_info.username_, wait_info.timestamp_);
-      for (int i = wait_info.start_pos_; i < wait_info.end_pos_; ++i) {
-        info.seat_num_[i] -= wait_info.num_;
-      }
+      SeatRangeAdd(info.seat_num_, wait_info.start_pos_, wait_info.end_pos_, -wait_info.num_);
       wait_info.queue = false;
     }
     if (it.IsEnd()) {
@@ -727,5 +643,27 @@ void TrainSystem::RefundTicket(const string para[26], const shared_ptr<UserSyste
     ++it;
   }
   ticket_system_->ModifyTicket(start_time.GetDate(), info);
+  query_cache_->InvalidateSeats({info.seats_, start_time.GetDate()});
   Succeed();
 }
+
+void TrainSystem::DumpIndex(const string para[26]) {
+  const string &name = para['i' - 'a'];
+  if (!name.empty() && name != "station" && name != "waitlist" && name != "seats" && name != "queries") {
+    Fail();
+    return;
+  }
+  cout << (name.empty() ? 4 : 1) << endl;
+  if (name.empty() || name == "station") {
+    cout << "station " << station_index_->Stats() << endl;
+  }
+  if (name.empty() || name == "waitlist") {
+    cout << "waitlist " << waitlist_->IndexStats() << endl;
+  }
+  if (name.empty() || name == "seats") {
+    cout << "seats " << ticket_system_->Cache() << endl;
+  }
+  if (name.empty() || name == "queries") {
+    cout << "queries " << *query_cache_ << endl;
+  }
+}
@@ -0,0 +1,40 @@
+#include "ticket/transfer_planner.h"
+
+#include <algorithm>
+
+void TransferPlanner::Build(const vector<DetailedTrainInfo> &trains, int32_t end_id) {
+  entries_.clear();
+  buckets_.clear();
+  min_price_ = INT32_MAX;
+  min_duration_ = INT32_MAX;
+  for (size_t k = 0; k < trains.size(); ++k) {
+    const auto &train = trains[k];
+    int32_t end_pos = 0;
+    while (end_pos < train.station_num_ && train.stations_[end_pos] != end_id) {
+      ++end_pos;
+    }
+    for (int32_t j = 0; j < end_pos; ++j) {
+      auto price = train.price_sum_[end_pos] - train.price_sum_[j];
+      auto duration = train.arrive_[end_pos] - train.leave_[j];
+      min_price_ = std::min(min_price_, price);
+      min_duration_ = std::min(min_duration_, duration);
+      entries_.push_back({train.stations_[j], {static_cast<int32_t>(k), j, end_pos, price, duration}, -1});
+    }
+  }
+  if (entries_.empty()) {
+    return;
+  }
+  size_t bucket_num = 1;
+  while (bucket_num < entries_.size()) {
+    bucket_num <<= 1;
+  }
+  mask_ = static_cast<int32_t>(bucket_num - 1);
+  for (size_t i = 0; i < bucket_num; ++i) {
+    buckets_.push_back(-1);
+  }
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    auto &head = buckets_[entries_[i].station_ & mask_];
+    entries_[i].next_ = head;
+    head = static_cast<int32_t>(i);
+  }
+}
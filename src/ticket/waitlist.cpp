@@ -4,7 +4,7 @@
 
 WaitList::WaitList(shared_ptr<BufferPoolManager> bpm)
   : bpm_(std::move(bpm)),
-    index_(new BPlusTree<pair<unsigned long long, Date>, signed int, std::less<>>(bpm_, std::less())){
+    index_(new BPlusTree<HashDateKey, signed int, std::less<>>(bpm_, std::less())){
   auto cur_guard = bpm_->FetchPageRead(0);
   auto cur_page = cur_guard.As<BPlusTreeHeaderPage>();
   next_tuple_id_ = cur_page->tuple_page_id_;
@@ -51,18 +51,19 @@ bool WaitList::iterator::IsEnd() {
 }
 
 WaitList::iterator WaitList::FetchWaitlist(const string& train_id, Date date) {
-  vector<page_id_t> page_id;
-  index_->GetValue(pair(StringHash(train_id), date), &page_id);
-  if (page_id.empty()) {
+  auto page_id = index_->Find(HashDateKey(StringHash(train_id), date));
+  if (!page_id.has_value()) {
+    return {};
+  }
+  auto cur_guard = bpm_->FetchPageWrite(*page_id);
+  if (!RemoveEmptyPage(train_id, date, cur_guard)) {
     return {};
   }
-  auto cur_guard = bpm_->FetchPageWrite(page_id[0]);
-  RemoveEmptyPage(train_id, date, cur_guard);
 
   return {bpm_, std::move(cur_guard), 0, train_id, date};
 }
 
-void WaitList::RemoveEmptyPage(const string& train_id, Date date, WritePageGuard& cur_guard) {
+bool WaitList::RemoveEmptyPage(const string& train_id, Date date, WritePageGuard& cur_guard) {
   bool flag = true;
   do {
     auto cur_page = cur_guard.As<LinkedTuplePage<WaitInfo>>();
@@ -72,30 +73,30 @@ void WaitList::RemoveEmptyPage(const string& train_id, Date date, WritePageGuard
       }
     }
     if (flag) {
-      index_->Remove(pair(StringHash(train_id), date));
       if (cur_page->GetNextPageId() == INVALID_PAGE_ID) {
+        index_->Remove(HashDateKey(StringHash(train_id), date));
         cur_guard = {};
-        return;
+        return false;
       }
-      index_->Insert(pair(StringHash(train_id), date), cur_page->GetNextPageId());
+      index_->Update(HashDateKey(StringHash(train_id), date), cur_page->GetNextPageId());
       cur_guard = bpm_->FetchPageWrite(cur_page->GetNextPageId());
     }
   } while (flag);
+  return true;
 }
 
 int32_t WaitList::Insert(const string& train_id, Date date, const string& username_,
                       int start_pos, int end_pos, int num) {
-  vector<page_id_t> page_id_v{};
-  index_->GetValue(pair(StringHash(train_id), date), &page_id_v);
+  auto page_id_v = index_->Find(HashDateKey(StringHash(train_id), date));
   LinkedTuplePage<WaitInfo> *cur_page;
-  if (page_id_v.empty()) {
+  if (!page_id_v.has_value()) {
     page_id_t page_id = INVALID_PAGE_ID;
     auto cur_guard = bpm_->NewPageGuarded(&page_id);
     cur_page = cur_guard.AsMut<LinkedTuplePage<WaitInfo>>();
     cur_page->SetNextPageId(INVALID_PAGE_ID);
-    index_->Insert(pair(StringHash(train_id), date), page_id);
+    index_->Insert(HashDateKey(StringHash(train_id), date), page_id);
   } else {
-    auto cur_guard = bpm_->FetchPageWrite(page_id_v[0]);
+    auto cur_guard = bpm_->FetchPageWrite(*page_id_v);
     auto tmp_page = cur_guard.As<LinkedTuplePage<WaitInfo>>();
     while (tmp_page->GetNextPageId() != INVALID_PAGE_ID) {
       cur_guard = bpm_->FetchPageWrite(tmp_page->GetNextPageId());
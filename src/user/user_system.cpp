@@ -1,7 +1,6 @@
 #include "user/user_system.h"
 
 #include "common/utils.h"
-#include "storage/page/tuple_page.h"
 
 using std::string;
 using std::ostream, std::cout, std::endl;
@@ -13,10 +12,11 @@ ostream &operator<<(ostream &os, const UserProfile &val) {
 
 UserSystem::UserSystem(shared_ptr<BufferPoolManager> bpm)
 : bpm_(std::move(bpm)),
-  index_(new BPlusTree<unsigned long long, RID, std::less<>>(bpm_, std::less<>())) {
+  index_(new ExtendibleHashTable<unsigned long long, UserProfile>(bpm_, USER_BLOOM_CAPACITY,
+                                                                   USER_HTABLE_HEADER_DEPTH)) {
   auto cur_guard = bpm_->FetchPageRead(0);
   auto cur_page = cur_guard.As<BPlusTreeHeaderPage>();
-  tuple_page_id_ = cur_page->tuple_page_id_;
+  user_num_ = cur_page->user_num_;
   login_timestamp_ = cur_page->dynamic_page_id_;
   if (login_timestamp_ == INVALID_PAGE_ID) {
     login_timestamp_ = 0;
@@ -27,22 +27,19 @@ UserSystem::UserSystem(shared_ptr<BufferPoolManager> bpm)
 UserSystem::~UserSystem() {
   auto cur_guard = bpm_->FetchPageWrite(0);
   auto cur_page = cur_guard.AsMut<BPlusTreeHeaderPage>();
-  cur_page->tuple_page_id_ = tuple_page_id_;
+  cur_page->user_num_ = user_num_;
   cur_page->dynamic_page_id_ = login_timestamp_;
 }
 
 void UserSystem::Login(string para[26]) {
   string &cur_user = para['u' - 'a'];
   string &password = para['p' - 'a'];
-  vector<RID> user_rid;
-  index_->GetValue(StringHash(cur_user), &user_rid);
-  if (user_rid.empty()) {
+  auto user_slot = index_->FindForUpdate(StringHash(cur_user));
+  if (user_slot.value_ == nullptr) {
     Fail();
     return;
   }
-  auto cur_guard = bpm_->FetchPageWrite(user_rid[0].page_id_);
-  auto cur_page = cur_guard.AsMut<TuplePage<UserProfile>>();
-  UserProfile &profile = cur_page->operator[](user_rid[0].pos_);
+  UserProfile &profile = *user_slot.value_;
   if (profile.login_info_ == login_timestamp_) {
     Fail();
   } else {
@@ -57,15 +54,12 @@ void UserSystem::Login(string para[26]) {
 
 void UserSystem::Logout(std::string para[26]) {
   string &cur_user = para['u' - 'a'];
-  vector<RID> user_rid;
-  index_->GetValue(StringHash(cur_user), &user_rid);
-  if (user_rid.empty()) {
+  auto user_slot = index_->FindForUpdate(StringHash(cur_user));
+  if (user_slot.value_ == nullptr) {
     Fail();
     return;
   }
-  auto cur_guard = bpm_->FetchPageWrite(user_rid[0].page_id_);
-  auto cur_page = cur_guard.AsMut<TuplePage<UserProfile>>();
-  UserProfile &profile = cur_page->operator[](user_rid[0].pos_);
+  UserProfile &profile = *user_slot.value_;
   if (profile.login_info_ != login_timestamp_) {
     Fail();
   } else {
@@ -81,7 +75,7 @@ void UserSystem::AddUser(std::string para[26]) {
   const string &name = para['n' - 'a'];
   const string &mail = para['m' - 'a'];
   auto privilege = static_cast<int8_t>(stoi(para['g' - 'a']));
-  bool is_first = (tuple_page_id_ == INVALID_PAGE_ID);
+  bool is_first = (user_num_ == 0);
   UserProfile cur_profile{};
   GetProfile(cur_username, cur_profile);
   if (!is_first && cur_profile.login_info_ != login_timestamp_) {
@@ -95,33 +89,19 @@ void UserSystem::AddUser(std::string para[26]) {
   if (is_first) {
     privilege = 10;
   }
-  vector<RID> tmp;
-  index_->GetValue(StringHash(username), &tmp);
-  if (!tmp.empty()) {
+  auto user_slot = index_->GetOrInsert(StringHash(username), UserProfile{});
+  if (!user_slot.inserted_) {
     Fail();
     return;
   }
-  UserProfile data;
+  UserProfile data{};
   username.copy(data.username_, string::npos);
   password.copy(data.password_, string::npos);
   name.copy(data.name_, string::npos);
   mail.copy(data.mail_addr_, string::npos);
   data.privilege_ = privilege;
-  if (tuple_page_id_ == INVALID_PAGE_ID) {
-    auto cur_guard = bpm_->NewPageGuarded(&tuple_page_id_);
-    auto cur_page = cur_guard.AsMut<TuplePage<UserProfile>>();
-    auto pos = cur_page->Append(data);
-    index_->Insert(StringHash(username), {tuple_page_id_, pos});
-  } else {
-    auto cur_guard = bpm_->FetchPageWrite(tuple_page_id_);
-    auto cur_page = cur_guard.AsMut<TuplePage<UserProfile>>();
-    if (cur_page->Full()) {
-      auto new_guard = bpm_->NewPageGuarded(&tuple_page_id_);
-      cur_page = new_guard.AsMut<TuplePage<UserProfile>>();
-    }
-    auto pos = cur_page->Append(data);
-    index_->Insert(StringHash(username), {tuple_page_id_, pos});
-  }
+  *user_slot.value_ = data;
+  ++user_num_;
   Succeed();
 }
 
@@ -134,15 +114,12 @@ void UserSystem::ModifyProfile(std::string para[26]) {
     Fail();
     return;
   }
-  vector<RID> user_rid;
-  index_->GetValue(StringHash(username), &user_rid);
-  if (user_rid.empty()) {
+  auto user_slot = index_->FindForUpdate(StringHash(username));
+  if (user_slot.value_ == nullptr) {
     Fail();
     return;
   }
-  auto cur_guard = bpm_->FetchPageWrite(user_rid[0].page_id_);
-  auto cur_page = cur_guard.AsMut<TuplePage<UserProfile>>();
-  UserProfile &data = cur_page->operator[](user_rid[0].pos_);
+  UserProfile &data = *user_slot.value_;
   if (data.privilege_ >= cur_profile.privilege_ && cur_username != username) {
     Fail();
     return;
@@ -185,7 +162,7 @@ void UserSystem::QueryProfile(std::string para[26]) {
     Fail();
     return;
   }
-  UserProfile data;
+  UserProfile data{};
   if (!GetProfile(username, data)) {
     Fail();
     return;
@@ -198,14 +175,11 @@ void UserSystem::QueryProfile(std::string para[26]) {
 }
 
 bool UserSystem::GetProfile(const std::string &username, UserProfile &profile) const {
-  vector<RID> user_rid;
-  index_->GetValue(StringHash(username), &user_rid);
-  if (user_rid.empty()) {
+  auto user_profile = index_->Find(StringHash(username));
+  if (!user_profile.has_value()) {
     return false;
   }
-  auto cur_guard = bpm_->FetchPageRead(user_rid[0].page_id_);
-  auto cur_page = cur_guard.As<TuplePage<UserProfile>>();
-  profile = cur_page->At(user_rid[0].pos_);
+  profile = *user_profile;
   return true;
 }
 